@@ -0,0 +1,198 @@
+#ifndef   HISTOGRAM_H
+#define   HISTOGRAM_H
+//////////////////////////////////////////////////////////////////////////////
+#include "typedef.h"
+
+#include <cmath>
+#include <atomic>
+#include <string>
+
+using namespace std;
+
+/**HDR（High Dynamic Range）风格的延迟直方图，单位由调用方决定（一般是微秒）。
+ * 数值按最高有效位分组，每组再线性划分为 SUB_COUNT 个子桶，相对误差不超过 1/SUB_COUNT，
+ * 取值范围是 [0, 2^32)，超出范围的数值记入最后一个桶。
+ * 计数器都是原子变量，record 不加锁，可以被多个线程同时调用。**/
+class Histogram
+{
+public:
+    static const int SUB_BITS = 6;
+    static const int SUB_COUNT = 1 << SUB_BITS;
+    static const int MAX_BITS = 32;
+    static const int BUCKET_COUNT = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+
+protected:
+    atomic<int64> total;
+    atomic<int64> sum;
+    atomic<int64> maxval;
+    atomic<int64> minval;
+    atomic<int64> counts[BUCKET_COUNT];
+
+public:
+    /**数值所在的桶**/
+    static int GetIndex(int64 val)
+    {
+        if (val < 0) val = 0;
+        if (val < 2 * SUB_COUNT) return (int)(val);
+        if (val >= (1LL << MAX_BITS)) return BUCKET_COUNT - 1;
+
+        int msb = 63 - __builtin_clzll((u_int64)(val));
+        int shift = msb - SUB_BITS;
+
+        return (shift + 1) * SUB_COUNT + (int)(val >> shift) - SUB_COUNT;
+    }
+    /**桶内数值的上界**/
+    static int64 GetValue(int idx)
+    {
+        if (idx < 2 * SUB_COUNT) return idx;
+
+        int shift = idx / SUB_COUNT - 1;
+        int64 sub = idx % SUB_COUNT + SUB_COUNT;
+
+        return ((sub + 1) << shift) - 1;
+    }
+
+public:
+    Histogram()
+    {
+        clear();
+    }
+    void clear()
+    {
+        total = 0;
+        sum = 0;
+        maxval = 0;
+        minval = INT64_MAX;
+
+        for (atomic<int64>& item : counts) item = 0;
+    }
+    void record(int64 val)
+    {
+        if (val < 0) val = 0;
+
+        counts[GetIndex(val)].fetch_add(1, memory_order_relaxed);
+        total.fetch_add(1, memory_order_relaxed);
+        sum.fetch_add(val, memory_order_relaxed);
+
+        int64 tmp = maxval.load(memory_order_relaxed);
+
+        while (val > tmp && !maxval.compare_exchange_weak(tmp, val, memory_order_relaxed));
+
+        tmp = minval.load(memory_order_relaxed);
+
+        while (val < tmp && !minval.compare_exchange_weak(tmp, val, memory_order_relaxed));
+    }
+    /**合并另一个直方图的数据，用于汇总各个线程各自记录的直方图**/
+    void merge(const Histogram& obj)
+    {
+        for (int i = 0; i < BUCKET_COUNT; i++)
+        {
+            int64 num = obj.counts[i].load(memory_order_relaxed);
+
+            if (num > 0) counts[i].fetch_add(num, memory_order_relaxed);
+        }
+
+        total.fetch_add(obj.total.load(), memory_order_relaxed);
+        sum.fetch_add(obj.sum.load(), memory_order_relaxed);
+
+        if (obj.getCount() > 0)
+        {
+            if (obj.getMax() > getMax()) maxval = obj.getMax();
+            if (obj.getMin() < minval.load()) minval = obj.getMin();
+        }
+    }
+    int64 getCount() const
+    {
+        return total.load(memory_order_relaxed);
+    }
+    int64 getSum() const
+    {
+        return sum.load(memory_order_relaxed);
+    }
+    int64 getMax() const
+    {
+        return maxval.load(memory_order_relaxed);
+    }
+    int64 getMin() const
+    {
+        return getCount() > 0 ? minval.load(memory_order_relaxed) : 0;
+    }
+    int64 getBucket(int idx) const
+    {
+        return counts[idx].load(memory_order_relaxed);
+    }
+    double getMean() const
+    {
+        int64 cnt = getCount();
+
+        return cnt > 0 ? (double)(getSum()) / cnt : 0;
+    }
+    /**百分位数（0~100）对应的数值，返回所在桶的上界，不超过记录到的最大值**/
+    int64 getPercentile(double percentile) const
+    {
+        int64 cnt = getCount();
+
+        if (cnt <= 0) return 0;
+
+        int64 num = 0;
+        int64 limit = (int64)(ceil(cnt * percentile / 100));
+
+        if (limit < 1) limit = 1;
+
+        for (int i = 0; i < BUCKET_COUNT; i++)
+        {
+            if ((num += getBucket(i)) >= limit) return min(GetValue(i), getMax());
+        }
+
+        return getMax();
+    }
+    /**按 HdrHistogram 的百分位分布格式输出，可以直接用 HdrHistogram 的绘图工具查看。
+     * 每次把剩余的比例减半，每一半输出 ticks 个百分位。**/
+    void print(FILE* out, int ticks = 5) const
+    {
+        int64 cnt = getCount();
+
+        fprintf(out, "%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+
+        if (cnt <= 0) return;
+
+        auto line = [&](double percentile){
+            int64 val = getPercentile(percentile * 100);
+            int64 num = 0;
+
+            for (int i = 0; i < BUCKET_COUNT && GetValue(i) <= val; i++) num += getBucket(i);
+
+            if (percentile < 1)
+            {
+                fprintf(out, "%12.3f %14.12f %10lld %14.2f\n", (double)(val), percentile, (long long)(num), 1 / (1 - percentile));
+            }
+            else
+            {
+                fprintf(out, "%12.3f %14.12f %10lld\n", (double)(val), percentile, (long long)(cnt));
+            }
+        };
+
+        for (double half = 1; half * cnt >= 1; half /= 2)
+        {
+            for (int i = 0; i < ticks; i++) line(1 - half + half / 2 * i / ticks);
+        }
+
+        line(1);
+
+        double mean = getMean();
+        double variance = 0;
+
+        for (int i = 0; i < BUCKET_COUNT; i++)
+        {
+            int64 num = getBucket(i);
+
+            if (num > 0) variance += num * pow(GetValue(i) - mean, 2);
+        }
+
+        fprintf(out, "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean, sqrt(variance / cnt));
+        fprintf(out, "#[Max     = %12.3f, Total count    = %12lld]\n", (double)(getMax()), (long long)(cnt));
+        fprintf(out, "#[Buckets = %12d, SubBuckets     = %12d]\n", MAX_BITS - SUB_BITS + 1, SUB_COUNT);
+    }
+};
+//////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,265 @@
+#ifndef   REDISBATCH_H
+#define   REDISBATCH_H
+//////////////////////////////////////////////////////////////////////////////
+#include <unordered_map>
+#include "Redisconnect_myself.h"
+
+/**合并读取的配置**/
+struct RedisBatchOption
+{
+    int window = 200;    /**第一个请求到达后等待其他请求加入的最长时间（微秒）**/
+    int maxsize = 64;    /**一批最多合并的请求数，达到后立即执行**/
+};
+
+/**合并多个线程同时发出的 GET、HGET：第一个请求的线程等待 window 微秒（或者凑满 maxsize 个请求），
+ * 然后用连接池中的一个连接把这一批请求（GET 逐条、HGET 按键合并成 HMGET）在一次往返中通过管道执行，
+ * 再把结果分给等待的线程。同一批中相同的键（字段）只读取一次，返回值和单独执行 get、hget 相同。
+ * 每一批都要等满 window 微秒或者凑满 maxsize 个请求才执行，没有其他并发请求时单独的一个请求也会多等待整个 window，
+ * 所以只适合很多线程同时读取、连接数或者往返次数是瓶颈的场景，需要先调用 RedisConnect::Setup。**/
+class RedisBatcher
+{
+public:
+    typedef RedisBatchOption Option;
+
+protected:
+    /**一批中去重后的一个读取项**/
+    struct Slot
+    {
+        bool hash = false;
+        string key;
+        string field;
+        string val;
+        int code = 0;
+    };
+    struct Batch
+    {
+        int size = 0;          /**加入这一批的请求数（去重前）**/
+        bool done = false;
+        vector<Slot> slots;
+        unordered_map<string, int> index;
+        condition_variable cv;
+
+        /**加入一个读取项，已有相同的项时复用，返回读取项的序号**/
+        int add(bool hash, const string& key, const string& field)
+        {
+            string name;
+
+            name.reserve(key.length() + field.length() + 2);
+            name += hash ? 'H' : 'G';
+            name += key;
+
+            if (hash)
+            {
+                name += '\0';
+                name += field;
+            }
+
+            auto res = index.emplace(std::move(name), (int)(slots.size()));
+
+            if (res.second)
+            {
+                slots.emplace_back();
+
+                Slot& item = slots.back();
+
+                item.hash = hash;
+                item.key = key;
+                item.field = field;
+            }
+
+            size++;
+
+            return res.first->second;
+        }
+    };
+
+    Option option;
+    mutex mtx;
+    condition_variable cv;
+    shared_ptr<Batch> current;
+    atomic<int64> requests;
+    atomic<int64> batches;
+
+protected:
+    /**逐个执行，只有一个读取项或者合并执行失败时使用**/
+    static void Execute(RedisConnect* redis, Slot& item)
+    {
+        item.code = item.hash ? redis->hget(item.key, item.field, item.val) : redis->get(item.key, item.val);
+    }
+    /**执行一批读取，结果保存在各个读取项中**/
+    static void Execute(Batch& batch)
+    {
+        shared_ptr<RedisConnect> redis = RedisConnect::Instance();
+
+        if (redis == NULL)
+        {
+            for (Slot& item : batch.slots) item.code = RedisConnect::NETERR;
+
+            return;
+        }
+
+        if (batch.slots.size() == 1) return Execute(redis.get(), batch.slots[0]);
+
+        /**GET 逐条放入管道，HGET 按键分组合并成 HMGET，order 是结果对应的读取项。
+         * GET 不合并成 MGET：MGET 对其他类型的键返回空值，而 GET 返回 WRONGTYPE 错误，合并后结果会和单独执行不同**/
+        vector<int> order;
+        vector<RedisConnect::Command> cmds;
+        unordered_map<string, size_t> groups;
+
+        for (size_t i = 0; i < batch.slots.size(); i++)
+        {
+            Slot& item = batch.slots[i];
+
+            if (item.hash) continue;
+
+            cmds.emplace_back("get");
+            cmds.back().add(item.key);
+            order.push_back(i);
+        }
+
+        size_t base = cmds.size();
+        vector<vector<int>> members;
+
+        for (size_t i = 0; i < batch.slots.size(); i++)
+        {
+            Slot& item = batch.slots[i];
+
+            if (!item.hash) continue;
+
+            auto res = groups.emplace(item.key, cmds.size());
+
+            if (res.second)
+            {
+                cmds.emplace_back("hmget");
+                cmds.back().add(item.key);
+                members.emplace_back();
+            }
+
+            cmds[res.first->second].add(item.field);
+            members[res.first->second - base].push_back(i);
+        }
+
+        for (const vector<int>& item : members) order.insert(order.end(), item.begin(), item.end());
+
+        vector<string_view> vec;
+        int res = redis->execute(vec, cmds);
+
+        /**有命令失败（例如 WRONGTYPE）时结果的个数对不上，改为逐个执行，让每个请求拿到自己的错误**/
+        if (vec.size() != order.size())
+        {
+            if (res < 0 && redis->isBroken())
+            {
+                for (Slot& item : batch.slots) item.code = res;
+
+                return;
+            }
+
+            for (Slot& item : batch.slots) Execute(redis.get(), item);
+
+            return;
+        }
+
+        for (size_t i = 0; i < vec.size(); i++)
+        {
+            Slot& item = batch.slots[order[i]];
+            string_view data = vec[i];
+
+            if (data.data() == NULL)
+            {
+                item.code = RedisConnect::NOTFUND;
+
+                continue;
+            }
+
+            int num = RedisConnect::COMPRESS_TYPE == RedisCompress::NONE ? 0 : RedisCompress::Uncompress(data, item.val);
+
+            if (num == 0) item.val.assign(data.data(), data.size());
+
+            item.code = num < 0 ? RedisConnect::DATAERR : RedisConnect::OK;
+        }
+    }
+    int request(bool hash, const string& key, const string& field, string& val)
+    {
+        unique_lock<mutex> lk(mtx);
+
+        bool leader = current == NULL;
+
+        if (leader) current = make_shared<Batch>();
+
+        shared_ptr<Batch> batch = current;
+        int idx = batch->add(hash, key, field);
+
+        requests++;
+
+        if (leader)
+        {
+            /**等待其他请求加入，凑满 maxsize 个请求时提前结束**/
+            cv.wait_for(lk, chrono::microseconds(option.window), [&](){
+                return batch->size >= option.maxsize;
+            });
+
+            if (current == batch) current = NULL;
+
+            lk.unlock();
+
+            Execute(*batch);
+
+            batches++;
+
+            lk.lock();
+
+            batch->done = true;
+
+            lk.unlock();
+
+            batch->cv.notify_all();
+        }
+        else
+        {
+            /**凑满后关闭这一批，后来的请求进入下一批**/
+            if (batch->size >= option.maxsize)
+            {
+                current = NULL;
+                cv.notify_all();
+            }
+
+            batch->cv.wait(lk, [&](){
+                return batch->done;
+            });
+
+            lk.unlock();
+        }
+
+        /**执行完成后读取项不再修改，不需要加锁**/
+        const Slot& item = batch->slots[idx];
+
+        val = item.val;
+
+        return item.code;
+    }
+
+public:
+    RedisBatcher(const Option& option = Option()) : option(option), requests(0), batches(0)
+    {
+    }
+    int get(const string& key, string& val)
+    {
+        return request(false, key, string(), val);
+    }
+    int hget(const string& key, const string& field, string& val)
+    {
+        return request(true, key, field, val);
+    }
+    /**合并前的请求数**/
+    int64 getRequests() const
+    {
+        return requests;
+    }
+    /**实际执行的批数**/
+    int64 getBatches() const
+    {
+        return batches;
+    }
+};
+//////////////////////////////////////////////////////////////////////////////
+#endif
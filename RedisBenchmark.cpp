@@ -0,0 +1,920 @@
+#include <map>
+#include <benchmark/benchmark.h>
+#include "Redisconnect_myself.h"
+
+/*
+ * 客户端热点路径的基准测试，依赖 google benchmark：
+ *
+ *     g++ -std=c++17 -O2 -o RedisBenchmark RedisBenchmark.cpp -lbenchmark -lpthread
+ *
+ * 安装了 lz4、zstd 的开发包时压缩用例会自动启用，需要再加上 -llz4 -lzstd。
+ *
+ * 端到端的用例连接进程内的 RESP 桩服务（监听 127.0.0.1 的随机端口），
+ * 只测量客户端自身的开销，不依赖外部的 redis 服务。
+ */
+
+class StubServer
+{
+protected:
+	int port = 0;
+	SOCKET sock = INVALID_SOCKET;
+	mutex mtx;
+	thread acceptor;
+	atomic<bool> stopped;
+	vector<thread> workers;
+	vector<SOCKET> clients;
+	map<string, string> data;
+
+protected:
+	/*
+	 * 解析一条 RESP 数组格式的命令，返回命令占用的字节数，数据不完整时返回0，格式错误时返回-1
+	 */
+	static int Parse(const char* msg, int len, vector<string>& argv)
+	{
+		const char* str = msg;
+		const char* tail = msg + len;
+
+		auto line = [&](int& val){
+			const char* end = (const char*)memchr(str, '\n', tail - str);
+
+			if (end == NULL) return false;
+
+			val = atoi(str + 1);
+			str = end + 1;
+
+			return true;
+		};
+
+		int cnt = 0;
+
+		argv.clear();
+
+		if (len <= 0) return 0;
+		if (*str != '*') return -1;
+		if (!line(cnt)) return 0;
+
+		while (cnt-- > 0)
+		{
+			int sz = 0;
+
+			if (str >= tail) return 0;
+			if (*str != '$') return -1;
+			if (!line(sz)) return 0;
+			if (tail - str < sz + 2) return 0;
+
+			argv.emplace_back(str, str + sz);
+			str += sz + 2;
+		}
+
+		return str - msg;
+	}
+	static void Bulk(string& out, const string& val)
+	{
+		out += "$" + to_string(val.length()) + "\r\n" + val + "\r\n";
+	}
+	void reply(vector<string>& argv, string& out)
+	{
+		string cmd = argv[0];
+
+		std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::toupper);
+
+		if (cmd == "PING")
+		{
+			out += "+PONG\r\n";
+		}
+		else if (cmd == "GET" && argv.size() > 1)
+		{
+			lock_guard<mutex> lk(mtx);
+
+			auto it = data.find(argv[1]);
+
+			if (it == data.end())
+			{
+				out += "$-1\r\n";
+			}
+			else
+			{
+				Bulk(out, it->second);
+			}
+		}
+		else if (cmd == "SET" && argv.size() > 2)
+		{
+			lock_guard<mutex> lk(mtx);
+
+			data[argv[1]] = argv[2];
+			out += "+OK\r\n";
+		}
+		else if (cmd == "DEL" && argv.size() > 1)
+		{
+			lock_guard<mutex> lk(mtx);
+
+			out += ":" + to_string(data.erase(argv[1])) + "\r\n";
+		}
+		else
+		{
+			out += "+OK\r\n";
+		}
+	}
+	void serve(SOCKET conn)
+	{
+		string in;
+		string out;
+		char buffer[64 * 1024];
+		vector<string> argv;
+
+		while (!stopped)
+		{
+			int len = recv(conn, buffer, sizeof(buffer), 0);
+
+			if (len <= 0) break;
+
+			in.append(buffer, len);
+
+			int pos = 0;
+
+			while (true)
+			{
+				int num = Parse(in.c_str() + pos, in.length() - pos, argv);
+
+				if (num < 0) return;
+				if (num == 0) break;
+
+				reply(argv, out);
+				pos += num;
+			}
+
+			in.erase(0, pos);
+
+			if (out.length() > 0)
+			{
+				if (send(conn, out.c_str(), out.length(), 0) < 0) break;
+
+				out.clear();
+			}
+		}
+	}
+
+public:
+	int getPort() const
+	{
+		return port;
+	}
+	bool start()
+	{
+		struct sockaddr_in addr;
+		socklen_t len = sizeof(addr);
+
+		memset(&addr, 0, sizeof(addr));
+
+		addr.sin_family = AF_INET;
+		addr.sin_port = 0;
+		addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+		stopped = false;
+		sock = socket(AF_INET, SOCK_STREAM, 0);
+
+		if (sock < 0) return false;
+
+		if (::bind(sock, (struct sockaddr*)(&addr), sizeof(addr)) < 0 || listen(sock, 128) < 0)
+		{
+			::close(sock);
+
+			return false;
+		}
+
+		getsockname(sock, (struct sockaddr*)(&addr), &len);
+		port = ntohs(addr.sin_port);
+
+		acceptor = thread([this](){
+			while (!stopped)
+			{
+				SOCKET conn = accept(sock, NULL, NULL);
+
+				if (conn < 0) break;
+
+				lock_guard<mutex> lk(mtx);
+
+				clients.push_back(conn);
+				workers.emplace_back([this, conn](){
+					serve(conn);
+				});
+			}
+		});
+
+		return true;
+	}
+	void stop()
+	{
+		stopped = true;
+
+		shutdown(sock, SHUT_RDWR);
+		::close(sock);
+
+		if (acceptor.joinable()) acceptor.join();
+
+		lock_guard<mutex> lk(mtx);
+
+		for (SOCKET conn : clients) shutdown(conn, SHUT_RDWR);
+
+		for (thread& item : workers) item.join();
+
+		for (SOCKET conn : clients) ::close(conn);
+
+		workers.clear();
+		clients.clear();
+	}
+};
+
+class BenchCommand : public RedisConnect::Command
+{
+public:
+	using Command::Command;
+
+	int parse(const char* msg, int len)
+	{
+		res.clear();
+
+		return Command::parse(msg, len);
+	}
+	/*
+	 * 把数组元素连续解析到 data 中，和 string_view 形式的 execute 使用的连接内存块相同
+	 */
+	int parse(const char* msg, int len, vector<char>& data, vector<pair<int, int>>& items)
+	{
+		flat = &data;
+		offsets = &items;
+
+		int res = Command::parse(msg, len);
+
+		flat = NULL;
+		offsets = NULL;
+
+		return res;
+	}
+	const vector<string>& result() const
+	{
+		return res;
+	}
+	/*
+	 * 上一次解析的响应占用的字节数，管道中用它定位下一条响应
+	 */
+	int consumed() const
+	{
+		return bytes;
+	}
+};
+
+static StubServer server;
+
+/*
+ * 当前线程的内存分配次数，端到端的用例用它输出每次操作的分配次数（allocs_per_op）。
+ * 替换全部形式的全局 operator new/delete（普通、数组、nothrow、对齐），统一经过 Allocate/Release 计数和释放；
+ * Allocate/Release 不内联，编译器看到的始终是配对的 operator new/delete，不会报 -Wmismatched-new-delete
+ */
+static thread_local int64 AllocCount = 0;
+
+__attribute__((noinline)) static void* Allocate(size_t size, size_t align, bool nothrow)
+{
+	void* ptr = NULL;
+
+	if (size == 0) size = 1;
+
+	if (align > alignof(max_align_t))
+	{
+		if (posix_memalign(&ptr, align, size) != 0) ptr = NULL;
+	}
+	else
+	{
+		ptr = malloc(size);
+	}
+
+	if (ptr == NULL)
+	{
+		if (nothrow) return NULL;
+
+		throw bad_alloc();
+	}
+
+	AllocCount++;
+
+	return ptr;
+}
+__attribute__((noinline)) static void Release(void* ptr) noexcept
+{
+	free(ptr);
+}
+
+void* operator new(size_t size)
+{
+	return Allocate(size, 0, false);
+}
+void* operator new[](size_t size)
+{
+	return Allocate(size, 0, false);
+}
+void* operator new(size_t size, const nothrow_t&) noexcept
+{
+	return Allocate(size, 0, true);
+}
+void* operator new[](size_t size, const nothrow_t&) noexcept
+{
+	return Allocate(size, 0, true);
+}
+void* operator new(size_t size, align_val_t align)
+{
+	return Allocate(size, (size_t)(align), false);
+}
+void* operator new[](size_t size, align_val_t align)
+{
+	return Allocate(size, (size_t)(align), false);
+}
+void* operator new(size_t size, align_val_t align, const nothrow_t&) noexcept
+{
+	return Allocate(size, (size_t)(align), true);
+}
+void* operator new[](size_t size, align_val_t align, const nothrow_t&) noexcept
+{
+	return Allocate(size, (size_t)(align), true);
+}
+void operator delete(void* ptr) noexcept
+{
+	Release(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+	Release(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept
+{
+	Release(ptr);
+}
+void operator delete[](void* ptr, size_t) noexcept
+{
+	Release(ptr);
+}
+void operator delete(void* ptr, const nothrow_t&) noexcept
+{
+	Release(ptr);
+}
+void operator delete[](void* ptr, const nothrow_t&) noexcept
+{
+	Release(ptr);
+}
+void operator delete(void* ptr, align_val_t) noexcept
+{
+	Release(ptr);
+}
+void operator delete[](void* ptr, align_val_t) noexcept
+{
+	Release(ptr);
+}
+void operator delete(void* ptr, size_t, align_val_t) noexcept
+{
+	Release(ptr);
+}
+void operator delete[](void* ptr, size_t, align_val_t) noexcept
+{
+	Release(ptr);
+}
+void operator delete(void* ptr, align_val_t, const nothrow_t&) noexcept
+{
+	Release(ptr);
+}
+void operator delete[](void* ptr, align_val_t, const nothrow_t&) noexcept
+{
+	Release(ptr);
+}
+
+static int64 GetNanoTime()
+{
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * 输出吞吐量（items_per_second）和延迟分位数（微秒），多线程时分位数取各线程的平均值
+ */
+static void ReportLatency(benchmark::State& state, vector<int64>& vec, int64 items)
+{
+	state.SetItemsProcessed(items);
+
+	if (vec.empty()) return;
+
+	std::sort(vec.begin(), vec.end());
+
+	auto percentile = [&](double val){
+		size_t idx = std::min(vec.size() - 1, (size_t)(val * vec.size()));
+
+		return benchmark::Counter(vec[idx] / 1000.0, benchmark::Counter::kAvgThreads);
+	};
+
+	state.counters["p50_us"] = percentile(0.50);
+	state.counters["p99_us"] = percentile(0.99);
+	state.counters["p999_us"] = percentile(0.999);
+}
+
+/*
+ * 输出每次操作的内存分配次数，allocs 是测试循环中当前线程的分配次数
+ */
+static void ReportAllocs(benchmark::State& state, int64 allocs, int64 items)
+{
+	if (items > 0) state.counters["allocs_per_op"] = benchmark::Counter((double)(allocs) / items, benchmark::Counter::kAvgThreads);
+}
+
+static void BM_CommandToString(benchmark::State& state)
+{
+	string val(state.range(0), 'x');
+	RedisConnect::Command cmd("set");
+
+	cmd.add("benchmark:key", val);
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(cmd.toString());
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(state.iterations() * val.length());
+}
+BENCHMARK(BM_CommandToString)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+
+/*
+ * 构造一条 SET 命令并编码的完整开销：mode 为0时用 add 生成参数列表再编码，
+ * 为1时用 encode 直接编码，为2时再加上预先编码的命令名
+ */
+static void BM_CommandBuild(benchmark::State& state)
+{
+	int mode = state.range(0);
+	string key = "benchmark:key";
+	string val(state.range(1), 'x');
+
+	for (auto _ : state)
+	{
+		RedisConnect::Command cmd;
+
+		if (mode == 0)
+		{
+			cmd.add("set", key, val);
+			benchmark::DoNotOptimize(cmd.toString());
+		}
+		else if (mode == 1)
+		{
+			cmd.encode("set", key, val);
+			benchmark::DoNotOptimize(cmd.toString());
+		}
+		else
+		{
+			cmd.encode(RedisConnect::Header::SET, key, val);
+			benchmark::DoNotOptimize(cmd.toString());
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CommandBuild)->ArgNames({"mode", "size"})->ArgsProduct({{0, 1, 2}, {16, 1024}});
+
+static void BM_CommandParseBulk(benchmark::State& state)
+{
+	BenchCommand cmd;
+	string msg = "$" + to_string(state.range(0)) + "\r\n" + string(state.range(0), 'x') + "\r\n";
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(cmd.parse(msg.c_str(), msg.length()));
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(state.iterations() * msg.length());
+}
+BENCHMARK(BM_CommandParseBulk)->Arg(16)->Arg(1024)->Arg(64 * 1024)->Arg(1024 * 1024);
+
+static void BM_CommandParseArray(benchmark::State& state)
+{
+	BenchCommand cmd;
+	string msg = "*" + to_string(state.range(0)) + "\r\n";
+
+	for (int i = 0; i < state.range(0); i++) msg += "$16\r\n" + string(16, 'a' + i % 26) + "\r\n";
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(cmd.parse(msg.c_str(), msg.length()));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * msg.length());
+}
+BENCHMARK(BM_CommandParseArray)->Arg(10)->Arg(1000)->Arg(100000);
+
+/*
+ * 同上，元素解析到复用的内存块中，不再为每个元素分配 string
+ */
+static void BM_CommandParseArrayView(benchmark::State& state)
+{
+	BenchCommand cmd;
+	vector<char> data;
+	vector<pair<int, int>> items;
+	string msg = "*" + to_string(state.range(0)) + "\r\n";
+
+	for (int i = 0; i < state.range(0); i++) msg += "$16\r\n" + string(16, 'a' + i % 26) + "\r\n";
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(cmd.parse(msg.c_str(), msg.length(), data, items));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * msg.length());
+}
+BENCHMARK(BM_CommandParseArrayView)->Arg(10)->Arg(1000)->Arg(100000);
+
+/*
+ * 嵌套数组不在最后的回复（如 EXEC、XRANGE）：所有层的元素都要解析出来，占用的字节数是整个回复的长度，
+ * 否则管道中后续的响应都会错位
+ */
+static bool CheckNestedReply(BenchCommand& cmd, vector<char>& data, vector<pair<int, int>>& items, int mode)
+{
+	string msg = "*3\r\n*1\r\n$1\r\na\r\n$1\r\nb\r\n*2\r\n$1\r\nc\r\n:5\r\n";
+	string next = msg + "+OK\r\n";
+
+	int num = mode ? cmd.parse(next.c_str(), next.length(), data, items) : cmd.parse(next.c_str(), next.length());
+
+	return num == 4 && cmd.consumed() == (int)(msg.length());
+}
+
+/*
+ * SCAN 形式的嵌套回复（游标之后是元素数组），mode 为0时解析成 string，为1时解析到内存块中。
+ * 开始前先检查游标和元素都保留在结果中（嵌套数组不能清空外层已经解析出的游标），以及嵌套数组之后的元素也会解析
+ */
+static void BM_CommandParseScan(benchmark::State& state)
+{
+	int mode = state.range(0);
+	BenchCommand cmd;
+	vector<char> data;
+	vector<pair<int, int>> items;
+	string msg = "*2\r\n$1\r\n7\r\n*" + to_string(state.range(1)) + "\r\n";
+
+	for (int i = 0; i < state.range(1); i++) msg += "$16\r\n" + string(16, 'a' + i % 26) + "\r\n";
+
+	int num = mode ? cmd.parse(msg.c_str(), msg.length(), data, items) : cmd.parse(msg.c_str(), msg.length());
+	bool cursor = mode ? (!items.empty() && items[0].second == 1 && data[items[0].first] == '7') : (!cmd.result().empty() && cmd.result()[0] == "7");
+
+	if (num != state.range(1) + 1 || !cursor)
+	{
+		state.SkipWithError("nested reply lost the cursor");
+
+		return;
+	}
+
+	if (!CheckNestedReply(cmd, data, items, mode))
+	{
+		state.SkipWithError("nested reply stopped before the outer elements");
+
+		return;
+	}
+
+	for (auto _ : state)
+	{
+		if (mode)
+		{
+			benchmark::DoNotOptimize(cmd.parse(msg.c_str(), msg.length(), data, items));
+		}
+		else
+		{
+			benchmark::DoNotOptimize(cmd.parse(msg.c_str(), msg.length()));
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(1));
+	state.SetBytesProcessed(state.iterations() * msg.length());
+}
+BENCHMARK(BM_CommandParseScan)->ArgNames({"mode", "size"})->ArgsProduct({{0, 1}, {10, 1000}});
+
+/*
+ * 逐个元素扫描多行回复的头部（$len\r\n）并跳过内容：mode 为0时用原来的 strstr + atoi，
+ * 为1时用 RedisScan，元素内容的长度是 size 字节
+ */
+static void BM_ScanReply(benchmark::State& state)
+{
+	int mode = state.range(0);
+	int size = state.range(1);
+	int count = 100000;
+	string msg = "*" + to_string(count) + "\r\n";
+
+	for (int i = 0; i < count; i++) msg += "$" + to_string(size) + "\r\n" + string(size, 'a' + i % 26) + "\r\n";
+
+	const char* tail = msg.c_str() + msg.length();
+
+	for (auto _ : state)
+	{
+		int64 total = 0;
+		const char* str = strstr(msg.c_str(), "\r\n") + 2;
+
+		while (str < tail)
+		{
+			int64 len = 0;
+			const char* end = NULL;
+
+			if (mode == 0)
+			{
+				end = strstr(str + 1, "\r\n");
+				len = atoi(str + 1);
+			}
+			else
+			{
+				end = RedisScan::ParseInt(str + 1, tail, len);
+			}
+
+			total += len;
+			str = end + 2 + len + 2;
+		}
+
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+	state.SetBytesProcessed(state.iterations() * msg.length());
+}
+BENCHMARK(BM_ScanReply)->ArgNames({"mode", "size"})->ArgsProduct({{0, 1}, {8, 64}});
+
+/*
+ * 查找状态行的结束符（+OK 之类的短行以及较长的错误信息）：mode 为0时用 strstr，为1时用 RedisScan
+ */
+static void BM_FindCRLF(benchmark::State& state)
+{
+	int mode = state.range(0);
+	string msg = "-" + string(state.range(1), 'e') + "\r\n";
+	const char* tail = msg.c_str() + msg.length();
+
+	for (auto _ : state)
+	{
+		if (mode == 0)
+		{
+			benchmark::DoNotOptimize(strstr(msg.c_str(), "\r\n"));
+		}
+		else
+		{
+			benchmark::DoNotOptimize(RedisScan::FindCRLF(msg.c_str(), tail));
+		}
+	}
+
+	state.SetBytesProcessed(state.iterations() * msg.length());
+}
+BENCHMARK(BM_FindCRLF)->ArgNames({"mode", "size"})->ArgsProduct({{0, 1}, {2, 64, 4096}});
+
+/*
+ * 生成大约 size 字节的 JSON 文档，用作压缩用例的数据
+ */
+static string MakeDocument(int size)
+{
+	string doc = "[";
+
+	for (int i = 0; (int)(doc.length()) < size; i++)
+	{
+		doc += "{\"id\":" + to_string(i) + ",\"name\":\"user" + to_string(i * 7919 % 10007) + "\",\"score\":" + to_string(i * 31 % 1000);
+		doc += ",\"active\":" + string(i % 3 ? "true" : "false") + ",\"tags\":[\"redis\",\"cache\"]},";
+	}
+
+	doc.back() = ']';
+
+	return doc;
+}
+
+/*
+ * 参数是压缩算法和文档大小，saved_ratio 是节省的字节比例，bytes_per_second 按原始大小计算
+ */
+static void BM_Compress(benchmark::State& state)
+{
+	string dest;
+	int type = state.range(0);
+	string doc = MakeDocument(state.range(1));
+
+	if (!RedisCompress::Support(type))
+	{
+		state.SkipWithError("compression not supported");
+
+		return;
+	}
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(RedisCompress::Compress(type, 0, doc, dest));
+	}
+
+	state.SetBytesProcessed(state.iterations() * doc.length());
+	state.counters["saved_ratio"] = 1 - (double)(dest.length()) / doc.length();
+}
+BENCHMARK(BM_Compress)->ArgNames({"type", "size"})->ArgsProduct({{RedisCompress::LZ4, RedisCompress::ZSTD}, {16 * 1024, 128 * 1024, 512 * 1024}});
+
+static void BM_Uncompress(benchmark::State& state)
+{
+	string src;
+	string dest;
+	int type = state.range(0);
+	string doc = MakeDocument(state.range(1));
+
+	if (!RedisCompress::Compress(type, 0, doc, src))
+	{
+		state.SkipWithError("compression not supported");
+
+		return;
+	}
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(RedisCompress::Uncompress(src, dest));
+	}
+
+	state.SetBytesProcessed(state.iterations() * doc.length());
+}
+BENCHMARK(BM_Uncompress)->ArgNames({"type", "size"})->ArgsProduct({{RedisCompress::LZ4, RedisCompress::ZSTD}, {16 * 1024, 128 * 1024, 512 * 1024}});
+
+static void BM_ResPoolGet(benchmark::State& state)
+{
+	static ResPool<int> pool([](){
+		return make_shared<int>(0);
+	}, 64, 60);
+
+	vector<int64> vec;
+
+	for (auto _ : state)
+	{
+		int64 start = GetNanoTime();
+		shared_ptr<int> data = pool.get();
+
+		benchmark::DoNotOptimize(data);
+		data = NULL;
+		vec.push_back(GetNanoTime() - start);
+	}
+
+	ReportLatency(state, vec, state.iterations());
+}
+BENCHMARK(BM_ResPoolGet)->Threads(1)->Threads(4)->Threads(16)->Threads(64)->UseRealTime();
+
+static void BM_RedisSet(benchmark::State& state)
+{
+	vector<int64> vec;
+	string val(state.range(0), 'x');
+	string key = "benchmark:" + to_string(state.thread_index());
+
+	int64 allocs = AllocCount;
+
+	for (auto _ : state)
+	{
+		int64 start = GetNanoTime();
+
+		if (RedisConnect::Instance()->set(key, val) < 0)
+		{
+			state.SkipWithError("set failed");
+
+			break;
+		}
+
+		vec.push_back(GetNanoTime() - start);
+	}
+
+	ReportLatency(state, vec, state.iterations());
+	ReportAllocs(state, AllocCount - allocs, state.iterations());
+}
+BENCHMARK(BM_RedisSet)->Arg(16)->Arg(4096)->Threads(1)->Threads(4)->UseRealTime();
+
+static void BM_RedisGet(benchmark::State& state)
+{
+	string val;
+	vector<int64> vec;
+	string key = "benchmark:" + to_string(state.thread_index());
+
+	RedisConnect::Instance()->set(key, string(state.range(0), 'x'));
+
+	int64 allocs = AllocCount;
+
+	for (auto _ : state)
+	{
+		int64 start = GetNanoTime();
+
+		if (RedisConnect::Instance()->get(key, val) < 0)
+		{
+			state.SkipWithError("get failed");
+
+			break;
+		}
+
+		vec.push_back(GetNanoTime() - start);
+	}
+
+	ReportLatency(state, vec, state.iterations());
+	ReportAllocs(state, AllocCount - allocs, state.iterations());
+}
+BENCHMARK(BM_RedisGet)->Arg(16)->Arg(4096)->Threads(1)->Threads(4)->UseRealTime();
+
+static void BM_RedisPipeline(benchmark::State& state)
+{
+	vector<int64> vec;
+	vector<RedisConnect::Command> cmds;
+	string key = "benchmark:" + to_string(state.thread_index());
+
+	for (int i = 0; i < state.range(0); i++)
+	{
+		RedisConnect::Command cmd(i % 2 ? "get" : "set");
+
+		if (i % 2)
+		{
+			cmd.add(key);
+		}
+		else
+		{
+			cmd.add(key, "value");
+		}
+
+		cmds.push_back(cmd);
+	}
+
+	int64 allocs = AllocCount;
+
+	for (auto _ : state)
+	{
+		int64 start = GetNanoTime();
+
+		if (RedisConnect::Instance()->execute(cmds) < 0)
+		{
+			state.SkipWithError("pipeline failed");
+
+			break;
+		}
+
+		vec.push_back(GetNanoTime() - start);
+	}
+
+	ReportLatency(state, vec, state.iterations() * state.range(0));
+	ReportAllocs(state, AllocCount - allocs, state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RedisPipeline)->Arg(10)->Arg(100)->Threads(1)->Threads(4)->UseRealTime();
+
+/*
+ * 不同 socket 选项下的命令延迟，mode 为0时是默认选项（TCP_NODELAY），1 关闭 TCP_NODELAY，
+ * 2 加上 TCP_QUICKACK，3 加上 SO_BUSY_POLL（50us），4 收发缓冲区设为 1MB。
+ * 用 setStream 把一条命令分成三次写入，可以看出 Nagle 算法对分段写入的影响
+ */
+static void BM_SocketOption(benchmark::State& state)
+{
+	int mode = state.range(0);
+	vector<int64> vec;
+	RedisConnect redis;
+	RedisConnect::SocketOption option;
+	string val(64, 'x');
+
+	if (mode == 1) option.nodelay = false;
+	if (mode == 2) option.quickack = true;
+	if (mode == 3) option.busypoll = 50;
+	if (mode == 4) option.sndbuf = option.rcvbuf = 1024 * 1024;
+
+	if (!redis.connect("127.0.0.1", server.getPort(), 3000, 2 * 1024 * 1024, option))
+	{
+		state.SkipWithError("connect failed");
+
+		return;
+	}
+
+	for (auto _ : state)
+	{
+		int64 start = GetNanoTime();
+		int res = redis.setStream("benchmark:option", val.length(), [&](char* dest, int len){
+			memcpy(dest, val.c_str(), len);
+
+			return len;
+		});
+
+		if (res < 0)
+		{
+			state.SkipWithError("set failed");
+
+			break;
+		}
+
+		vec.push_back(GetNanoTime() - start);
+	}
+
+	ReportLatency(state, vec, state.iterations());
+}
+BENCHMARK(BM_SocketOption)->ArgName("mode")->DenseRange(0, 4)->UseRealTime();
+
+int main(int argc, char** argv)
+{
+	if (!server.start())
+	{
+		printf("启动RESP桩服务失败\n");
+
+		return -1;
+	}
+
+	RedisConnect::Setup("127.0.0.1", server.getPort());
+
+	benchmark::Initialize(&argc, argv);
+
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) return -1;
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+
+	server.stop();
+
+	return 0;
+}
@@ -0,0 +1,213 @@
+#ifndef   REDISBREAKER_H
+#define   REDISBREAKER_H
+//////////////////////////////////////////////////////////////////////////////
+#include "typedef.h"
+#include "RedisRandom.h"
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**熔断器的状态快照**/
+struct RedisBreakerStat
+{
+    int state = 0;         /**当前状态（RedisBreaker::CLOSED、OPEN、HALFOPEN）**/
+    int failures = 0;      /**连续失败的次数**/
+    int delay = 0;         /**当前的熔断时间（毫秒）**/
+    int64 opens = 0;       /**进入熔断状态的次数**/
+    int64 rejects = 0;     /**熔断期间被直接拒绝的次数**/
+};
+
+/**按服务端地址区分的熔断器，保护建立连接的过程：
+ * 1）CLOSED：正常状态，连续失败 threshold 次后进入 OPEN；
+ * 2）OPEN：熔断状态，所有请求直接拒绝，熔断时间到期后进入 HALFOPEN；
+ * 3）HALFOPEN：只放行一个探测请求，其他请求继续拒绝，探测成功回到 CLOSED，失败再次进入 OPEN。
+ * 每次进入 OPEN 熔断时间翻倍（mindelay 到 maxdelay 之间），实际等待时间在熔断时间的一半到全部之间随机取值，
+ * 避免多个进程在同一时刻重连。CLOSED 状态下 acquire 和成功的 release 都不加锁。**/
+class RedisBreaker
+{
+public:
+    static const int CLOSED = 0;
+    static const int OPEN = 1;
+    static const int HALFOPEN = 2;
+
+    /**熔断策略，maxdelay 小于等于0表示不熔断**/
+    struct Policy
+    {
+        int threshold = 3;    /**连续失败多少次后熔断**/
+        int mindelay = 100;   /**第一次熔断的时间（毫秒）**/
+        int maxdelay = 5000;  /**熔断时间的上限（毫秒）**/
+    };
+
+protected:
+    mutex mtx;
+    Policy policy;
+    atomic<int> state;
+    atomic<int> failures;
+    int delay = 0;
+    int64 retrytime = 0;
+    atomic<int64> opens;
+    atomic<int64> rejects;
+
+    /**进入熔断状态，调用前需要加锁**/
+    void open()
+    {
+        delay = min(max(delay * 2, policy.mindelay), policy.maxdelay);
+        retrytime = Now() + delay / 2 + (int64)(RedisRandom::Next() % (delay / 2 + 1));
+
+        state = OPEN;
+        opens++;
+    }
+
+public:
+    RedisBreaker() : state(CLOSED), failures(0), opens(0), rejects(0)
+    {
+    }
+    /**单调时钟的当前时间（毫秒）**/
+    static int64 Now()
+    {
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    /**是否允许发起请求，返回 true 时请求结束后需要调用 release 报告结果**/
+    bool acquire()
+    {
+        if (state.load(memory_order_acquire) == CLOSED) return true;
+
+        lock_guard<mutex> lk(mtx);
+
+        if (state == CLOSED) return true;
+
+        if (state == HALFOPEN || Now() < retrytime)
+        {
+            rejects++;
+
+            return false;
+        }
+
+        state = HALFOPEN;
+
+        return true;
+    }
+    /**报告请求的结果**/
+    void release(bool success)
+    {
+        if (success && failures.load(memory_order_relaxed) == 0 && state.load(memory_order_acquire) == CLOSED) return;
+
+        lock_guard<mutex> lk(mtx);
+
+        if (success)
+        {
+            delay = 0;
+            failures = 0;
+            state = CLOSED;
+
+            return;
+        }
+
+        /**熔断期间报告的失败来自熔断之前已经放行的请求，不再延长熔断时间**/
+        if (state == OPEN) return;
+
+        failures++;
+
+        if (policy.maxdelay <= 0) return;
+
+        /**只在正常状态下达到失败次数或者探测请求失败时进入熔断**/
+        if (state == HALFOPEN || failures >= policy.threshold) open();
+    }
+    /**回到正常状态并清空失败次数**/
+    void reset()
+    {
+        lock_guard<mutex> lk(mtx);
+
+        delay = 0;
+        failures = 0;
+        retrytime = 0;
+        state = CLOSED;
+    }
+    int getState() const
+    {
+        return state;
+    }
+    RedisBreakerStat getStat()
+    {
+        RedisBreakerStat stat;
+
+        lock_guard<mutex> lk(mtx);
+
+        stat.state = state;
+        stat.delay = delay;
+        stat.failures = failures;
+        stat.opens = opens;
+        stat.rejects = rejects;
+
+        return stat;
+    }
+    void setPolicy(const Policy& policy)
+    {
+        lock_guard<mutex> lk(mtx);
+
+        this->policy = policy;
+    }
+
+protected:
+    /**按地址保存的全部熔断器和它们共用的熔断策略**/
+    struct Registry
+    {
+        mutex mtx;
+        Policy policy;
+        map<string, unique_ptr<RedisBreaker>> breakers;
+    };
+    static Registry& GetRegistry()
+    {
+        static Registry registry;
+
+        return registry;
+    }
+
+public:
+    /**查找地址对应的熔断器，不存在时按 SetPolicyAll 设置的策略创建。熔断器在进程退出时才释放，返回的指针可以一直使用。**/
+    static RedisBreaker* Get(const string& host, int port)
+    {
+        Registry& registry = GetRegistry();
+        string name = host + ":" + to_string(port);
+        lock_guard<mutex> lk(registry.mtx);
+        unique_ptr<RedisBreaker>& item = registry.breakers[name];
+
+        if (item == NULL)
+        {
+            item.reset(new RedisBreaker());
+            item->setPolicy(registry.policy);
+        }
+
+        return item.get();
+    }
+    /**设置所有地址（包括之后才创建的地址）的熔断策略**/
+    static void SetPolicyAll(const Policy& policy)
+    {
+        Registry& registry = GetRegistry();
+        lock_guard<mutex> lk(registry.mtx);
+
+        registry.policy = policy;
+
+        for (auto& item : registry.breakers) item.second->setPolicy(policy);
+    }
+    /**所有地址的熔断器状态，地址的格式为 "host:port"**/
+    static vector<pair<string, RedisBreakerStat>> GetStatAll()
+    {
+        vector<pair<string, RedisBreakerStat>> vec;
+        Registry& registry = GetRegistry();
+        lock_guard<mutex> lk(registry.mtx);
+
+        for (auto& item : registry.breakers) vec.emplace_back(item.first, item.second->getStat());
+
+        return vec;
+    }
+};
+//////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,317 @@
+#ifndef   REDISCODEC_H
+#define   REDISCODEC_H
+//////////////////////////////////////////////////////////////////////////////
+#include "typedef.h"
+
+#include <string>
+#include <vector>
+#include <charconv>
+#include <type_traits>
+
+using namespace std;
+
+/**单个值与 redis 字符串之间的转换，用于哈希的字段值。
+ * 支持整数、浮点数、bool、枚举和 string，其他类型可以特化 RedisField<T> 并提供同样的 Encode/Decode。
+ * 数值用 to_chars/from_chars 转换，不受 locale 影响，浮点数使用能精确还原的最短表示。**/
+template<class T, class = void>
+struct RedisField;
+
+template<>
+struct RedisField<string>
+{
+    static void Encode(const string& val, string& dest)
+    {
+        dest = val;
+    }
+    /**src 在解码后不再使用，字符串直接移动**/
+    static bool Decode(string& src, string& val)
+    {
+        val.swap(src);
+
+        return true;
+    }
+};
+
+template<>
+struct RedisField<bool>
+{
+    static void Encode(bool val, string& dest)
+    {
+        dest = val ? "1" : "0";
+    }
+    static bool Decode(string& src, bool& val)
+    {
+        if (src == "1" || src == "true") val = true;
+        else if (src == "0" || src == "false") val = false;
+        else return false;
+
+        return true;
+    }
+};
+
+template<class T>
+struct RedisField<T, typename enable_if<is_arithmetic<T>::value && !is_same<T, bool>::value>::type>
+{
+    static void Encode(T val, string& dest)
+    {
+        char buffer[64];
+        auto res = to_chars(buffer, buffer + sizeof(buffer), val);
+
+        dest.assign(buffer, res.ptr);
+    }
+    static bool Decode(string& src, T& val)
+    {
+        const char* end = src.c_str() + src.length();
+        auto res = from_chars(src.c_str(), end, val);
+
+        return res.ec == errc() && res.ptr == end;
+    }
+};
+
+template<class T>
+struct RedisField<T, typename enable_if<is_enum<T>::value>::type>
+{
+    typedef typename underlying_type<T>::type Base;
+
+    static void Encode(T val, string& dest)
+    {
+        RedisField<Base>::Encode((Base)(val), dest);
+    }
+    static bool Decode(string& src, T& val)
+    {
+        Base tmp;
+
+        if (!RedisField<Base>::Decode(src, tmp)) return false;
+
+        val = (T)(tmp);
+
+        return true;
+    }
+};
+
+/**结构体与 redis 数据之间的映射，通过特化提供 Visit，依次把字段名和字段的引用交给 func：
+ *
+ *     template<> struct RedisCodec<User>
+ *     {
+ *         static const bool DEFINED = true;
+ *
+ *         template<class OBJ, class FUNC> static void Visit(OBJ& obj, FUNC&& func)
+ *         {
+ *             func("id", obj.id);
+ *             func("name", obj.name);
+ *         }
+ *     };
+ *
+ * 字段名和成员名相同时可以直接用 REDIS_CODEC(User, id, name)。
+ * 字段的类型需要支持 RedisField（写成哈希时）或 RedisPack（写成二进制时）。**/
+template<class T>
+struct RedisCodec
+{
+    static const bool DEFINED = false;
+};
+
+/**二进制打包：数值按主机字节序（小端）定长保存，字符串和数组前面是 4 字节的长度，
+ * 有 RedisCodec 的结构体按字段顺序依次打包，所以字段的顺序和类型变化后旧数据无法读取。**/
+template<class T, class = void>
+struct RedisPack;
+
+template<class T>
+struct RedisPack<T, typename enable_if<is_arithmetic<T>::value || is_enum<T>::value>::type>
+{
+    static void Pack(const T& val, string& dest)
+    {
+        dest.append((const char*)(&val), sizeof(val));
+    }
+    static bool Unpack(const char*& str, const char* end, T& val)
+    {
+        if (end - str < (int)(sizeof(val))) return false;
+
+        memcpy(&val, str, sizeof(val));
+        str += sizeof(val);
+
+        return true;
+    }
+};
+
+template<>
+struct RedisPack<string>
+{
+    static void Pack(const string& val, string& dest)
+    {
+        RedisPack<u_int32>::Pack(val.length(), dest);
+        dest.append(val);
+    }
+    static bool Unpack(const char*& str, const char* end, string& val)
+    {
+        u_int32 len;
+
+        if (!RedisPack<u_int32>::Unpack(str, end, len) || end - str < (int64)(len)) return false;
+
+        val.assign(str, len);
+        str += len;
+
+        return true;
+    }
+};
+
+template<class T>
+struct RedisPack<vector<T>>
+{
+    static void Pack(const vector<T>& vec, string& dest)
+    {
+        RedisPack<u_int32>::Pack(vec.size(), dest);
+
+        for (const T& item : vec) RedisPack<T>::Pack(item, dest);
+    }
+    static bool Unpack(const char*& str, const char* end, vector<T>& vec)
+    {
+        u_int32 len;
+
+        if (!RedisPack<u_int32>::Unpack(str, end, len) || end - str < (int64)(len)) return false;
+
+        vec.resize(len);
+
+        for (T& item : vec)
+        {
+            if (!RedisPack<T>::Unpack(str, end, item)) return false;
+        }
+
+        return true;
+    }
+};
+
+template<class T>
+struct RedisPack<T, typename enable_if<RedisCodec<T>::DEFINED>::type>
+{
+    static void Pack(const T& obj, string& dest)
+    {
+        RedisCodec<T>::Visit(obj, [&](const char*, const auto& val){
+            RedisPack<typename decay<decltype(val)>::type>::Pack(val, dest);
+        });
+    }
+    static bool Unpack(const char*& str, const char* end, T& obj)
+    {
+        bool res = true;
+
+        RedisCodec<T>::Visit(obj, [&](const char*, auto& val){
+            if (res) res = RedisPack<typename decay<decltype(val)>::type>::Unpack(str, end, val);
+        });
+
+        return res;
+    }
+};
+
+/**对象与 redis 数据之间的转换接口**/
+class RedisObject
+{
+public:
+    /**把对象的字段依次以 field、value 追加到 vec 中，用于 HSET 的参数**/
+    template<class T>
+    static void ToHash(const T& obj, vector<string>& vec)
+    {
+        RedisCodec<T>::Visit(obj, [&](const char* name, const auto& val){
+            vec.emplace_back(name);
+            vec.emplace_back();
+            RedisField<typename decay<decltype(val)>::type>::Encode(val, vec.back());
+        });
+    }
+    /**从 HGETALL 返回的 field、value 列表中读取对象的字段，列表中的值会被移走。
+     * 不属于对象的字段被忽略，对象中没有出现在列表里的字段保持原值，返回读取到的字段数，值的格式错误时返回-1。
+     * 哈希一般按写入顺序返回字段，所以先尝试按顺序匹配，匹配不到时再查找全部字段。**/
+    template<class T>
+    static int FromHash(vector<string>& vec, T& obj)
+    {
+        int cnt = 0;
+        int num = 0;
+        int idx = 0;
+
+        RedisCodec<T>::Visit(obj, [&](const char*, auto&){
+            num++;
+        });
+
+        for (size_t i = 0; i + 1 < vec.size(); i += 2)
+        {
+            /**第 target 个字段的名称与 vec[i] 相同时解码，返回 1，名称不同返回 0，值的格式错误返回 -1**/
+            auto apply = [&](int target){
+                int pos = 0;
+                int res = 0;
+
+                RedisCodec<T>::Visit(obj, [&](const char* name, auto& val){
+                    if (pos++ != target || vec[i] != name) return;
+
+                    res = RedisField<typename decay<decltype(val)>::type>::Decode(vec[i + 1], val) ? 1 : -1;
+                });
+
+                return res;
+            };
+
+            int res = apply(idx);
+
+            for (int j = 0; j < num && res == 0; j++)
+            {
+                if (j != idx && (res = apply(j)) != 0) idx = j;
+            }
+
+            if (res < 0) return -1;
+            if (res == 0) continue;
+
+            cnt++;
+            idx = (idx + 1) % num;
+        }
+
+        return cnt;
+    }
+    /**把对象打包成二进制数据，追加到 dest 中**/
+    template<class T>
+    static void Pack(const T& obj, string& dest)
+    {
+        RedisPack<T>::Pack(obj, dest);
+    }
+    /**从二进制数据中解出对象，数据长度不匹配时返回 false**/
+    template<class T>
+    static bool Unpack(const string& src, T& obj)
+    {
+        const char* str = src.c_str();
+        const char* end = str + src.length();
+
+        return RedisPack<T>::Unpack(str, end, obj) && str == end;
+    }
+};
+
+#define REDIS_CODEC_FIELD(name) func(#name, obj.name);
+#define REDIS_CODEC_EXPAND(x) x
+#define REDIS_CODEC_1(x) REDIS_CODEC_FIELD(x)
+#define REDIS_CODEC_2(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_1(__VA_ARGS__))
+#define REDIS_CODEC_3(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_2(__VA_ARGS__))
+#define REDIS_CODEC_4(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_3(__VA_ARGS__))
+#define REDIS_CODEC_5(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_4(__VA_ARGS__))
+#define REDIS_CODEC_6(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_5(__VA_ARGS__))
+#define REDIS_CODEC_7(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_6(__VA_ARGS__))
+#define REDIS_CODEC_8(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_7(__VA_ARGS__))
+#define REDIS_CODEC_9(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_8(__VA_ARGS__))
+#define REDIS_CODEC_10(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_9(__VA_ARGS__))
+#define REDIS_CODEC_11(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_10(__VA_ARGS__))
+#define REDIS_CODEC_12(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_11(__VA_ARGS__))
+#define REDIS_CODEC_13(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_12(__VA_ARGS__))
+#define REDIS_CODEC_14(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_13(__VA_ARGS__))
+#define REDIS_CODEC_15(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_14(__VA_ARGS__))
+#define REDIS_CODEC_16(x, ...) REDIS_CODEC_FIELD(x) REDIS_CODEC_EXPAND(REDIS_CODEC_15(__VA_ARGS__))
+#define REDIS_CODEC_COUNT(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ...) REDIS_CODEC_##N
+#define REDIS_CODEC_FIELDS(...) REDIS_CODEC_EXPAND(REDIS_CODEC_COUNT(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)(__VA_ARGS__))
+
+/**为结构体生成 RedisCodec 特化，字段名和成员名相同，最多 16 个字段，需要在全局命名空间中使用。
+ * 字段更多或者需要改名时直接特化 RedisCodec。**/
+#define REDIS_CODEC(TYPE, ...)                                          \
+template<>                                                              \
+struct RedisCodec<TYPE>                                                 \
+{                                                                       \
+    static const bool DEFINED = true;                                   \
+                                                                        \
+    template<class OBJ, class FUNC>                                     \
+    static void Visit(OBJ& obj, FUNC&& func)                            \
+    {                                                                   \
+        REDIS_CODEC_FIELDS(__VA_ARGS__)                                 \
+    }                                                                   \
+};
+//////////////////////////////////////////////////////////////////////////////
+#endif
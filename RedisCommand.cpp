@@ -1,4 +1,7 @@
-#include "RedisConnect.h"
+#include "Histogram.h"
+#include "Redisconnect_myself.h"
+
+#include <random>
 
 #define ColorPrint(__COLOR__, __FMT__, ...)		\
 SetConsoleTextColor(__COLOR__);					\
@@ -41,6 +44,209 @@ bool CheckCommand(const char* fmt, ...)
 	return false;
 }
 
+/*
+ * bench 子命令的参数，参考 redis-benchmark：
+ * -t 线程数  -c 连接数（连接池大小）  -n 请求总数  -P 管道深度
+ * -d 值大小（固定值或 min-max 区间）  -r 键空间大小  -k 键分布（uniform 或 zipf）
+ * -s zipf 分布的参数  -w 写请求百分比  -o 直方图输出文件
+ */
+struct BenchOption
+{
+	int threads = 1;
+	int connections = 8;
+	int requests = 100000;
+	int pipeline = 1;
+	int minsz = 64;
+	int maxsz = 64;
+	int keyspace = 10000;
+	int writes = 10;
+	double zipf = 0.99;
+	string dist = "uniform";
+	string output;
+
+	bool parse(int argc, char** argv)
+	{
+		for (int i = 2; i < argc; i++)
+		{
+			const char* key = argv[i];
+			const char* val = i + 1 < argc ? argv[i + 1] : NULL;
+
+			if (key[0] != '-' || key[1] == 0 || key[2] != 0 || val == NULL) return false;
+
+			switch (key[1])
+			{
+				case 't': threads = atoi(val); break;
+				case 'c': connections = atoi(val); break;
+				case 'n': requests = atoi(val); break;
+				case 'P': pipeline = atoi(val); break;
+				case 'r': keyspace = atoi(val); break;
+				case 'w': writes = atoi(val); break;
+				case 's': zipf = atof(val); break;
+				case 'k': dist = val; break;
+				case 'o': output = val; break;
+				case 'd':
+					if (const char* ptr = strchr(val, '-'))
+					{
+						minsz = atoi(val);
+						maxsz = atoi(ptr + 1);
+					}
+					else
+					{
+						minsz = maxsz = atoi(val);
+					}
+					break;
+				default:
+					return false;
+			}
+
+			i++;
+		}
+
+		if (dist != "uniform" && dist != "zipf") return false;
+
+		return threads > 0 && connections > 0 && requests > 0 && pipeline > 0 && keyspace > 0 && minsz >= 0 && maxsz >= minsz;
+	}
+};
+
+/*
+ * 按均匀分布或 zipf 分布生成键的序号，zipf 分布预先计算累积分布，生成时二分查找
+ */
+class KeyGenerator
+{
+protected:
+	int keyspace;
+	vector<double> cdf;
+
+public:
+	KeyGenerator(const BenchOption& opt) : keyspace(opt.keyspace)
+	{
+		if (opt.dist != "zipf") return;
+
+		double sum = 0;
+
+		cdf.resize(keyspace);
+
+		for (int i = 0; i < keyspace; i++) cdf[i] = sum += 1 / pow(i + 1, opt.zipf);
+		for (double& item : cdf) item /= sum;
+	}
+	int next(mt19937_64& rand) const
+	{
+		if (cdf.empty()) return rand() % keyspace;
+
+		double val = uniform_real_distribution<double>(0, 1)(rand);
+
+		return std::min((int)(lower_bound(cdf.begin(), cdf.end(), val) - cdf.begin()), keyspace - 1);
+	}
+};
+
+int Bench(int argc, char** argv, const char* host, int port, const char* passwd)
+{
+	BenchOption opt;
+
+	if (!opt.parse(argc, argv))
+	{
+		ColorPrint(eRED, "%s\n", "用法: bench [-t 线程数] [-c 连接数] [-n 请求数] [-P 管道深度] [-d 值大小|min-max] [-r 键空间] [-k uniform|zipf] [-s zipf参数] [-w 写百分比] [-o 直方图文件]");
+
+		return -1;
+	}
+
+	RedisConnect::POOL_MAXLEN = opt.connections;
+	RedisConnect::POOL_MINIDLE = opt.connections;
+	RedisConnect::Setup(host, port, passwd ? passwd : "");
+
+	if (!RedisConnect::Instance())
+	{
+		ColorPrint(eRED, "REDIS[%s][%d]连接失败\n", host, port);
+
+		return -1;
+	}
+
+	Histogram histogram;
+	KeyGenerator generator(opt);
+	atomic<int64> errors(0);
+	atomic<int> remain(opt.requests);
+	string value(opt.maxsz, 'x');
+	vector<thread> workers;
+
+	auto work = [&](int idx){
+		char key[64];
+		mt19937_64 rand(idx + 1);
+		vector<RedisConnect::Command> cmds;
+		uniform_int_distribution<int> size(opt.minsz, opt.maxsz);
+
+		while (true)
+		{
+			int num = std::min(opt.pipeline, remain.fetch_sub(opt.pipeline));
+
+			if (num <= 0) break;
+
+			cmds.clear();
+
+			for (int i = 0; i < num; i++)
+			{
+				snprintf(key, sizeof(key), "key:%08d", generator.next(rand));
+
+				if ((int)(rand() % 100) < opt.writes)
+				{
+					RedisConnect::Command cmd("set");
+
+					cmd.add(string(key), value.substr(0, size(rand)));
+					cmds.push_back(cmd);
+				}
+				else
+				{
+					RedisConnect::Command cmd("get");
+
+					cmd.add(string(key));
+					cmds.push_back(cmd);
+				}
+			}
+
+			auto start = chrono::steady_clock::now();
+			shared_ptr<RedisConnect> redis = RedisConnect::Instance();
+
+			int res = redis ? redis->execute(cmds) : RedisConnect::NETERR;
+
+			/*最后一条 GET 的键不存在时返回 NOTFUND，不算失败*/
+			if (res >= 0 || res == RedisConnect::NOTFUND)
+			{
+				histogram.record(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+			}
+			else
+			{
+				errors += num;
+			}
+		}
+	};
+
+	auto start = chrono::steady_clock::now();
+
+	for (int i = 0; i < opt.threads; i++) workers.emplace_back(work, i);
+
+	for (thread& item : workers) item.join();
+
+	double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	ColorPrint(eWHITE, "%s\n", "--------------------------------------");
+	ColorPrint(eWHITE, "线程数[%d] 连接数[%d] 管道深度[%d] 值大小[%d-%d] 键空间[%d][%s] 写比例[%d%%]\n", opt.threads, opt.connections, opt.pipeline, opt.minsz, opt.maxsz, opt.keyspace, opt.dist.c_str(), opt.writes);
+	ColorPrint(eGREEN, "共执行%d个请求，耗时%.3f秒，吞吐量%.2f请求/秒\n", opt.requests, elapsed, opt.requests / elapsed);
+	ColorPrint(errors > 0 ? eRED : eGREEN, "失败请求%lld个\n", (long long)(errors.load()));
+	ColorPrint(eWHITE, "延迟(微秒, 每批%d个请求) p50[%lld] p99[%lld] p999[%lld] max[%lld]\n", opt.pipeline, (long long)(histogram.getPercentile(50)), (long long)(histogram.getPercentile(99)), (long long)(histogram.getPercentile(99.9)), (long long)(histogram.getMax()));
+	ColorPrint(eWHITE, "%s\n", "--------------------------------------");
+
+	if (opt.output.empty())
+	{
+		histogram.print(stdout);
+	}
+	else if (FILE* out = fopen(opt.output.c_str(), "w"))
+	{
+		histogram.print(out);
+		fclose(out);
+	}
+
+	return 0;
+}
+
 int main(int argc, char** argv)
 {
 	auto GetCmdParam = [&](int idx){
@@ -58,9 +264,12 @@ int main(int argc, char** argv)
 	const char* host = getenv("REDIS_HOST");
 	const char* passwd = getenv("REDIS_PASSWORD");
 
-	if (host)
+	/*
+	 * REDIS_HOST 的格式为 host:port、[ipv6]:port 或者 unix:/path，不带端口的 IPv6 地址直接使用
+	 */
+	if (host && strncmp(host, "unix:", 5))
 	{
-		if (ptr = strchr(host, ':'))
+		if ((ptr = strrchr(host, ':')) && (*host == '[' ? ptr[-1] == ']' : strchr(host, ':') == ptr))
 		{
 			static string shost(host, ptr);
 			port = atoi(ptr + 1);
@@ -70,6 +279,8 @@ int main(int argc, char** argv)
 
 	if (host == NULL || *host == 0) host = "127.0.0.1";
 
+	if (cmd && strcasecmp(cmd, "bench") == 0) return Bench(argc, argv, host, port, passwd);
+
 	if (redis.connect(host, port))
 	{
 		if (passwd && *passwd)
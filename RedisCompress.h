@@ -0,0 +1,142 @@
+#ifndef   REDISCOMPRESS_H
+#define   REDISCOMPRESS_H
+//////////////////////////////////////////////////////////////////////////////
+#include "typedef.h"
+
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+/**压缩库是可选的，包含了头文件就启用，同时需要链接对应的库（-llz4、-lzstd）。
+ * 有头文件但不想链接时可以定义 REDIS_NO_LZ4、REDIS_NO_ZSTD 关闭。**/
+#if defined(__has_include)
+#if __has_include(<lz4.h>) && !defined(REDIS_NO_LZ4)
+#include <lz4.h>
+#define REDIS_HAS_LZ4
+#endif
+#if __has_include(<zstd.h>) && !defined(REDIS_NO_ZSTD)
+#include <zstd.h>
+#define REDIS_HAS_ZSTD
+#endif
+#endif
+
+/**值的压缩和解压。压缩后的数据以 HEAD_SIZE 字节的头部开始：
+ * 3 字节的标记 "\0RZ"、1 字节的压缩算法、4 字节的原始长度（小端序），后面是压缩后的数据。
+ * 以这个标记开头的未压缩值会被当作压缩数据，正常的文本数据不会以 '\0' 开头，
+ * RedisConnect 只在开启压缩（COMPRESS_TYPE 不是 NONE）时才检查这个标记。**/
+class RedisCompress
+{
+public:
+    static const int NONE = 0;
+    static const int LZ4 = 1;
+    static const int ZSTD = 2;
+    static const int HEAD_SIZE = 8;
+    static const int MAX_SIZE = 512 * 1024 * 1024;  /**redis 字符串的最大长度，超过时认为头部已损坏**/
+
+public:
+    /**是否编译了压缩算法的支持**/
+    static bool Support(int type)
+    {
+#ifdef REDIS_HAS_LZ4
+        if (type == LZ4) return true;
+#endif
+#ifdef REDIS_HAS_ZSTD
+        if (type == ZSTD) return true;
+#endif
+        (void)(type);
+
+        return false;
+    }
+    /**数据是否以压缩标记开头**/
+    static bool IsCompressed(string_view data)
+    {
+        return data.length() >= HEAD_SIZE && data[0] == 0 && data[1] == 'R' && data[2] == 'Z';
+    }
+    /**压缩数据，level 是 zstd 的压缩级别或 lz4 的加速因子，0 表示默认值。
+     * 不支持该算法或者压缩后没有变小时返回 false，这时应该保存原始数据。**/
+    static bool Compress(int type, int level, const string& src, string& dest)
+    {
+        int len = -1;
+        int size = src.length();
+
+        if (size <= HEAD_SIZE || size > MAX_SIZE) return false;
+
+#ifdef REDIS_HAS_LZ4
+        if (type == LZ4)
+        {
+            dest.resize(HEAD_SIZE + LZ4_compressBound(size));
+            len = LZ4_compress_fast(src.c_str(), &dest[HEAD_SIZE], size, dest.length() - HEAD_SIZE, level > 0 ? level : 1);
+
+            if (len <= 0) len = -1;
+        }
+#endif
+#ifdef REDIS_HAS_ZSTD
+        if (type == ZSTD)
+        {
+            dest.resize(HEAD_SIZE + ZSTD_compressBound(size));
+
+            size_t res = ZSTD_compress(&dest[HEAD_SIZE], dest.length() - HEAD_SIZE, src.c_str(), size, level);
+
+            len = ZSTD_isError(res) ? -1 : (int)(res);
+        }
+#endif
+        (void)(type);
+        (void)(level);
+
+        if (len < 0 || HEAD_SIZE + len >= size) return false;
+
+        dest.resize(HEAD_SIZE + len);
+        dest[0] = 0;
+        dest[1] = 'R';
+        dest[2] = 'Z';
+        dest[3] = (char)(type);
+
+        for (int i = 0; i < 4; i++) dest[4 + i] = (char)((u_int32)(size) >> (i * 8));
+
+        return true;
+    }
+    /**解压数据，数据没有压缩标记时返回0，解压成功返回1，算法不支持或数据损坏时返回-1**/
+    static int Uncompress(string_view src, string& dest)
+    {
+        if (!IsCompressed(src)) return 0;
+
+        int type = (u_char)(src[3]);
+        u_int32 size = 0;
+        int64 len = -1;
+        const char* data = src.data() + HEAD_SIZE;
+        int datalen = src.length() - HEAD_SIZE;
+
+        for (int i = 0; i < 4; i++) size |= (u_int32)((u_char)(src[4 + i])) << (i * 8);
+
+        if (size > MAX_SIZE) return -1;
+
+        dest.resize(size);
+
+#ifdef REDIS_HAS_LZ4
+        if (type == LZ4) len = LZ4_decompress_safe(data, &dest[0], datalen, size);
+#endif
+#ifdef REDIS_HAS_ZSTD
+        if (type == ZSTD)
+        {
+            size_t res = ZSTD_decompress(&dest[0], size, data, datalen);
+
+            len = ZSTD_isError(res) ? -1 : (int64)(res);
+        }
+#endif
+        (void)(type);
+        (void)(data);
+        (void)(datalen);
+
+        if (len != (int64)(size))
+        {
+            dest.clear();
+
+            return -1;
+        }
+
+        return 1;
+    }
+};
+//////////////////////////////////////////////////////////////////////////////
+#endif
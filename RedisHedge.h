@@ -0,0 +1,227 @@
+#ifndef   REDISHEDGE_H
+#define   REDISHEDGE_H
+//////////////////////////////////////////////////////////////////////////////
+#include "Redisconnect_myself.h"
+
+/**对冲读取的配置**/
+struct RedisHedgeOption
+{
+    double percentile = 95;   /**对冲延迟取请求延迟的这个百分位数**/
+    int mindelay = 1000;      /**对冲延迟的下限（微秒），等待的精度是毫秒**/
+    int delay = 5000;         /**样本不足时的对冲延迟（微秒）**/
+    double budget = 0.05;     /**对冲请求占全部请求的最大比例**/
+};
+
+/**对冲读取：读命令先发给一个节点，超过对冲延迟还没有响应时，把同样的命令通过另一个节点的连接再发一次，取先到的响应。
+ * 对冲延迟按最近请求延迟的百分位数（percentile）计算，样本不足时使用固定的 delay，
+ * 对冲请求的数量不超过全部请求的 budget 比例，避免节点整体变慢时把负载放大一倍。
+ * 节点是同一份数据的主节点和副本，各自有独立的连接池，连接使用 Setup 的密码、超时和 socket 选项。
+ * 没有被采用的响应还在路上，对应的连接不能再执行其他命令，直接从连接池中移除。**/
+class RedisHedge
+{
+public:
+    typedef RedisHedgeOption Option;
+
+protected:
+    static const int MIN_SAMPLES = 100;     /**计算百分位数需要的最少样本数**/
+    static const int MAX_SAMPLES = 65536;   /**样本数超过后清空重新统计，跟上延迟的变化**/
+    static const int REFRESH_INTERVAL = 64; /**每隔多少个请求重新计算一次对冲延迟**/
+    static const int BUDGET_UNIT = 1000;    /**一个对冲请求消耗的额度**/
+
+    typedef ResPool<RedisConnect> Pool;
+
+    Option option;
+    vector<unique_ptr<Pool>> pools;
+    Histogram latency;
+    atomic<u_int32> next;
+    atomic<int64> delay;
+    atomic<int64> tokens;
+    atomic<int64> requests;
+    atomic<int64> hedges;
+    atomic<int64> wins;
+
+protected:
+    /**从第 idx 个节点的连接池获取连接，失效的连接移出连接池后继续获取**/
+    shared_ptr<RedisConnect> grasp(size_t idx)
+    {
+        shared_ptr<RedisConnect> redis;
+
+        while ((redis = pools[idx]->get()) && redis->isBroken()) pools[idx]->disable(redis);
+
+        return redis;
+    }
+    /**当前的对冲延迟（微秒），每 REFRESH_INTERVAL 个请求按延迟直方图重新计算一次**/
+    int64 getDelay()
+    {
+        if (requests.fetch_add(1, memory_order_relaxed) % REFRESH_INTERVAL == 0)
+        {
+            int64 cnt = latency.getCount();
+
+            if (cnt >= MIN_SAMPLES) delay = max((int64)(option.mindelay), latency.getPercentile(option.percentile));
+
+            if (cnt >= MAX_SAMPLES) latency.clear();
+        }
+
+        return delay.load(memory_order_relaxed);
+    }
+    /**每个请求增加 budget 个额度，对冲请求消耗一个，额度最多积累到 100 个对冲请求**/
+    void deposit()
+    {
+        int64 num = tokens.fetch_add((int64)(option.budget * BUDGET_UNIT), memory_order_relaxed);
+
+        if (num > 100 * BUDGET_UNIT) tokens.fetch_sub(num - 100 * BUDGET_UNIT, memory_order_relaxed);
+    }
+    bool withdraw()
+    {
+        if (tokens.fetch_sub(BUDGET_UNIT, memory_order_relaxed) >= BUDGET_UNIT) return true;
+
+        tokens.fetch_add(BUDGET_UNIT, memory_order_relaxed);
+
+        return false;
+    }
+    /**等待 a、b 中先可读的连接，返回 0 或 1，超时或出错时返回 -1**/
+    static int WaitAny(RedisConnect* a, RedisConnect* b, int timeout)
+    {
+        struct pollfd fds[2];
+
+        fds[0].fd = a->sock.getHandle();
+        fds[1].fd = b->sock.getHandle();
+        fds[0].events = fds[1].events = POLLIN;
+        fds[0].revents = fds[1].revents = 0;
+
+#ifdef LINUX
+        int num = poll(fds, 2, timeout);
+#else
+        int num = WSAPoll(fds, 2, timeout);
+#endif
+        if (num <= 0) return -1;
+
+        return fds[0].revents ? 0 : 1;
+    }
+    /**执行一条读命令，结果（单个值）解压后保存在 val 中**/
+    template<class ...ARGS>
+    int request(string& val, const ARGS& ...args)
+    {
+        size_t cnt = pools.size();
+
+        if (cnt == 0) return RedisConnect::PARAMERR;
+
+        size_t idx = next.fetch_add(1, memory_order_relaxed) % cnt;
+        shared_ptr<RedisConnect> first = grasp(idx);
+
+        /**节点不可用时直接使用下一个节点**/
+        for (size_t i = 1; first == NULL && i < cnt; i++) first = grasp(idx = (idx + 1) % cnt);
+
+        if (first == NULL) return RedisConnect::NETERR;
+
+        int64 start = RedisTrace::Now();
+        RedisConnect::Command& cmd = first->prepare();
+
+        cmd.encode(args...);
+        deposit();
+
+        if (first->submit(cmd) < 0)
+        {
+            pools[idx]->disable(first);
+
+            return RedisConnect::NETERR;
+        }
+
+        int code = 0;
+        int timeout = first->timeout;
+        int64 wait = getDelay();
+        shared_ptr<RedisConnect> second;
+        shared_ptr<RedisConnect> winner = first;
+        size_t other = (idx + 1) % cnt;
+
+        /**对冲延迟内没有响应，并且还有额度时向另一个节点发出同样的命令**/
+        if (cnt > 1 && !first->sock.wait((int)((wait + 999) / 1000)) && withdraw())
+        {
+            if ((second = grasp(other)) != NULL)
+            {
+                RedisConnect::Command& tmp = second->prepare();
+
+                tmp.encode(args...);
+
+                if (second->submit(tmp) < 0)
+                {
+                    pools[other]->disable(second);
+                    second = NULL;
+                }
+            }
+
+            if (second)
+            {
+                hedges++;
+
+                int elapsed = (int)((RedisTrace::Now() - start) / 1000);
+
+                if (WaitAny(first.get(), second.get(), max(timeout - elapsed, 0)) == 1)
+                {
+                    winner = second;
+                    wins++;
+                }
+            }
+        }
+
+        code = winner->receive(winner->context, max(timeout - (int)((RedisTrace::Now() - start) / 1000), 0), val);
+
+        /**落选连接的响应还没有读取，不能放回连接池**/
+        if (second)
+        {
+            if (winner == first) pools[other]->disable(second);
+            else pools[idx]->disable(first);
+        }
+
+        /**键不存在和服务端返回的错误也是正常的响应**/
+        if (code >= 0 || code == RedisConnect::NOTFUND || code == RedisConnect::FAIL) latency.record(RedisTrace::Now() - start);
+
+        return code;
+    }
+
+public:
+    /**endpoints 是各节点的地址，格式为 "host:port"（IPv6 地址写成 "[::1]:6379"），需要先调用 RedisConnect::Setup**/
+    RedisHedge(const vector<string>& endpoints, const Option& option = Option()) : option(option), next(0), delay(option.delay), tokens(0), requests(0), hedges(0), wins(0)
+    {
+        for (const string& item : endpoints)
+        {
+            size_t pos = item.rfind(':');
+
+            if (pos == string::npos) continue;
+
+            string host = item.substr(0, pos);
+            int port = atoi(item.c_str() + pos + 1);
+
+            if (host.length() > 1 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.length() - 2);
+
+            pools.emplace_back(new Pool([host, port](){
+                return RedisConnect::Create(host, port);
+            }, RedisConnect::POOL_MAXLEN));
+        }
+    }
+    int get(const string& key, string& val)
+    {
+        return request(val, RedisConnect::Header::GET, key);
+    }
+    int hget(const string& key, const string& field, string& val)
+    {
+        return request(val, RedisConnect::Header::HGET, key, field);
+    }
+    /**发出的对冲请求数**/
+    int64 getHedges() const
+    {
+        return hedges;
+    }
+    /**对冲请求先于原请求返回的次数**/
+    int64 getWins() const
+    {
+        return wins;
+    }
+    /**当前的对冲延迟（微秒）**/
+    int64 getCurrentDelay() const
+    {
+        return delay;
+    }
+};
+//////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,342 @@
+#ifndef   REDISMETRICS_H
+#define   REDISMETRICS_H
+//////////////////////////////////////////////////////////////////////////////
+#include "ResPool.h"
+#include "Histogram.h"
+#include "RedisBreaker.h"
+#include "RedisRandom.h"
+
+/**客户端的运行指标：按命令类型统计的调用次数、错误次数、收发字节数和延迟直方图（微秒），以及连接池的状态。
+ * 命令类型保存在一个固定大小的开放寻址表中，新类型通过 CAS 插入，记录指标的过程不加锁。**/
+class RedisMetrics
+{
+public:
+    static const int MAX_COMMANDS = 128;
+
+    /**单个命令类型的指标**/
+    class Command
+    {
+    public:
+        char name[32];
+        atomic<int64> calls;
+        atomic<int64> errors;
+        atomic<int64> sendbytes;
+        atomic<int64> recvbytes;
+        Histogram latency;
+
+        Command(const char* name) : calls(0), errors(0), sendbytes(0), recvbytes(0)
+        {
+            int len = 0;
+
+            while (name[len] && len < (int)(sizeof(this->name)) - 1)
+            {
+                this->name[len] = toupper(name[len]);
+                len++;
+            }
+
+            this->name[len] = 0;
+        }
+        void record(int64 usec, int sendsz, int recvsz, bool failed)
+        {
+            calls.fetch_add(1, memory_order_relaxed);
+            sendbytes.fetch_add(sendsz, memory_order_relaxed);
+            recvbytes.fetch_add(recvsz, memory_order_relaxed);
+
+            if (failed) errors.fetch_add(1, memory_order_relaxed);
+
+            latency.record(usec);
+        }
+    };
+
+    /**某个命令类型在某一时刻的指标快照**/
+    struct CommandStat
+    {
+        string name;
+        int64 calls = 0;
+        int64 errors = 0;
+        int64 sendbytes = 0;
+        int64 recvbytes = 0;
+        int64 latency = 0;  /**累计延迟（微秒）**/
+        int64 p50 = 0;
+        int64 p90 = 0;
+        int64 p99 = 0;
+        int64 p999 = 0;
+        int64 max = 0;
+    };
+
+    /**指标快照，可以导出为 Prometheus 文本格式**/
+    struct Snapshot
+    {
+        ResPoolStat pool;
+        vector<pair<string, RedisBreakerStat>> breakers;  /**各地址（"host:port"）的熔断器状态**/
+        vector<CommandStat> commands;
+
+        string toPrometheus(const string& prefix = "redis_client") const
+        {
+            ostringstream out;
+
+            auto head = [&](const string& name, const char* type, const char* help){
+                out << "# HELP " << prefix << "_" << name << " " << help << "\n";
+                out << "# TYPE " << prefix << "_" << name << " " << type << "\n";
+            };
+            auto line = [&](const string& name, const string& label, int64 val){
+                out << prefix << "_" << name;
+
+                if (label.length() > 0) out << "{" << label << "}";
+
+                out << " " << val << "\n";
+            };
+            auto counter = [&](const char* name, const char* help, int64 CommandStat::*field){
+                head(name, "counter", help);
+
+                for (const CommandStat& item : commands) line(name, "command=\"" + item.name + "\"", item.*field);
+            };
+
+            counter("commands_total", "Number of commands executed.", &CommandStat::calls);
+            counter("command_errors_total", "Number of commands that failed.", &CommandStat::errors);
+            counter("command_sent_bytes_total", "Bytes written for commands.", &CommandStat::sendbytes);
+            counter("command_received_bytes_total", "Bytes of replies parsed.", &CommandStat::recvbytes);
+
+            head("command_latency_microseconds", "summary", "Command latency from write to parsed reply.");
+
+            for (const CommandStat& item : commands)
+            {
+                string label = "command=\"" + item.name + "\"";
+
+                line("command_latency_microseconds", label + ",quantile=\"0.5\"", item.p50);
+                line("command_latency_microseconds", label + ",quantile=\"0.9\"", item.p90);
+                line("command_latency_microseconds", label + ",quantile=\"0.99\"", item.p99);
+                line("command_latency_microseconds", label + ",quantile=\"0.999\"", item.p999);
+                line("command_latency_microseconds", label + ",quantile=\"1\"", item.max);
+                line("command_latency_microseconds_sum", label, item.latency);
+                line("command_latency_microseconds_count", label, item.calls);
+            }
+
+            head("pool_connections", "gauge", "Pooled connections by state.");
+            line("pool_connections", "state=\"in_use\"", pool.inuse);
+            line("pool_connections", "state=\"idle\"", pool.idle);
+            head("pool_max_connections", "gauge", "Maximum number of pooled connections.");
+            line("pool_max_connections", "", pool.maxlen);
+            head("pool_waits_total", "counter", "Number of pool requests that had to wait for a free connection.");
+            line("pool_waits_total", "", pool.waits);
+            head("pool_wait_milliseconds_total", "counter", "Time spent waiting for a free connection.");
+            line("pool_wait_milliseconds_total", "", pool.waittime);
+            head("pool_creations_total", "counter", "Number of connections created by the pool.");
+            line("pool_creations_total", "", pool.creations);
+            head("pool_evictions_total", "counter", "Number of connections removed from the pool.");
+            line("pool_evictions_total", "", pool.evictions);
+            head("circuit_state", "gauge", "Connection circuit breaker state: 0 closed, 1 open, 2 half-open.");
+
+            for (const auto& item : breakers) line("circuit_state", "endpoint=\"" + item.first + "\"", item.second.state);
+
+            head("circuit_opens_total", "counter", "Number of times the circuit breaker opened.");
+
+            for (const auto& item : breakers) line("circuit_opens_total", "endpoint=\"" + item.first + "\"", item.second.opens);
+
+            head("circuit_rejects_total", "counter", "Connection attempts rejected while the circuit breaker was open.");
+
+            for (const auto& item : breakers) line("circuit_rejects_total", "endpoint=\"" + item.first + "\"", item.second.rejects);
+
+            return out.str();
+        }
+    };
+
+protected:
+    static atomic<Command*>* GetTable()
+    {
+        static atomic<Command*> table[MAX_COMMANDS];
+
+        return table;
+    }
+
+public:
+    /**查找命令类型对应的指标，不存在时插入，命令类型超过 MAX_COMMANDS 个时返回 NULL。
+     * 表中的对象在进程退出前不会释放，返回的指针可以一直使用。**/
+    static Command* Get(const string& name)
+    {
+        u_int32 hash = 0;
+        atomic<Command*>* table = GetTable();
+
+        for (char ch : name) hash = hash * 31 + toupper(ch);
+
+        for (int i = 0; i < MAX_COMMANDS; i++)
+        {
+            atomic<Command*>& slot = table[(hash + i) % MAX_COMMANDS];
+            Command* item = slot.load(memory_order_acquire);
+
+            if (item == NULL)
+            {
+                Command* tmp = new Command(name.c_str());
+
+                if (slot.compare_exchange_strong(item, tmp, memory_order_acq_rel)) return tmp;
+
+                delete tmp;
+            }
+
+            if (strncasecmp(item->name, name.c_str(), sizeof(item->name) - 1) == 0) return item;
+        }
+
+        return NULL;
+    }
+    static void Record(const string& name, int64 usec, int sendsz, int recvsz, bool failed)
+    {
+        Command* item = Get(name);
+
+        if (item) item->record(usec, sendsz, recvsz, failed);
+    }
+    /**所有命令类型的指标快照，按命令名排序**/
+    static vector<CommandStat> GetCommandStat()
+    {
+        vector<CommandStat> vec;
+        atomic<Command*>* table = GetTable();
+
+        for (int i = 0; i < MAX_COMMANDS; i++)
+        {
+            Command* item = table[i].load(memory_order_acquire);
+
+            if (item == NULL) continue;
+
+            CommandStat stat;
+
+            stat.name = item->name;
+            stat.calls = item->calls.load();
+            stat.errors = item->errors.load();
+            stat.sendbytes = item->sendbytes.load();
+            stat.recvbytes = item->recvbytes.load();
+            stat.latency = item->latency.getSum();
+            stat.p50 = item->latency.getPercentile(50);
+            stat.p90 = item->latency.getPercentile(90);
+            stat.p99 = item->latency.getPercentile(99);
+            stat.p999 = item->latency.getPercentile(99.9);
+            stat.max = item->latency.getMax();
+
+            vec.push_back(stat);
+        }
+
+        std::sort(vec.begin(), vec.end(), [](const CommandStat& a, const CommandStat& b){
+            return a.name < b.name;
+        });
+
+        return vec;
+    }
+    /**清空所有命令类型的指标**/
+    static void Reset()
+    {
+        atomic<Command*>* table = GetTable();
+
+        for (int i = 0; i < MAX_COMMANDS; i++)
+        {
+            Command* item = table[i].load(memory_order_acquire);
+
+            if (item == NULL) continue;
+
+            item->calls = 0;
+            item->errors = 0;
+            item->sendbytes = 0;
+            item->recvbytes = 0;
+            item->latency.clear();
+        }
+    }
+};
+
+/**一条命令的跟踪信息，时间单位都是微秒**/
+struct RedisTrace
+{
+    string command;        /**命令名**/
+    string key;            /**命令的第一个参数，一般是键**/
+    int code = 0;          /**执行结果**/
+    int sendsz = 0;        /**命令的字节数**/
+    int recvsz = 0;        /**响应的字节数**/
+    int64 poolwait = 0;    /**从连接池获取连接的耗时，只记在获取连接后的第一条命令上**/
+    int64 write = 0;       /**写入命令的耗时**/
+    int64 firstbyte = 0;   /**写入完成到收到第一个字节的耗时**/
+    int64 parse = 0;       /**解析响应的累计耗时**/
+    int64 total = 0;       /**从开始写入到解析完成的总耗时**/
+
+    static int64 Now()
+    {
+        return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+/**命令跟踪接口，通过 RedisTracer::Setup 安装后，在每条命令执行完成时判断是否需要上报：
+ * 耗时超过 slowtime（微秒，小于等于0表示不按耗时上报）的命令一定上报，其余命令按 sample（0~1）的比例抽样上报。
+ * 没有安装时命令执行过程中不会读取时钟，也不会构造跟踪信息。
+ * trace 在执行命令的线程中同步调用，实现需要是线程安全的，并且不能耗时太久。**/
+class RedisTracer
+{
+public:
+    int slowtime = 0;
+    double sample = 0;
+
+protected:
+    static atomic<RedisTracer*>& GetSlot()
+    {
+        static atomic<RedisTracer*> slot(NULL);
+
+        return slot;
+    }
+
+public:
+    virtual ~RedisTracer()
+    {
+    }
+    virtual void trace(const RedisTrace& item) = 0;
+
+    /**是否上报这条命令**/
+    bool accept(const RedisTrace& item) const
+    {
+        if (slowtime > 0 && item.total >= slowtime) return true;
+        if (sample <= 0) return false;
+        if (sample >= 1) return true;
+
+        return RedisRandom::NextDouble() < sample;
+    }
+
+public:
+    /**当前安装的跟踪接口，没有安装时返回 NULL**/
+    static RedisTracer* Get()
+    {
+        return GetSlot().load(memory_order_acquire);
+    }
+    /**安装跟踪接口，传入 NULL 表示关闭。
+     * 其他线程可能还在使用之前安装的对象，所以安装过的对象都保留到进程退出。**/
+    static void Setup(shared_ptr<RedisTracer> tracer)
+    {
+        static mutex mtx;
+        static vector<shared_ptr<RedisTracer>> vec;
+
+        lock_guard<mutex> lk(mtx);
+
+        if (tracer) vec.push_back(tracer);
+
+        GetSlot().store(tracer.get(), memory_order_release);
+    }
+};
+
+/**把跟踪信息逐行输出到文件的默认实现**/
+class RedisTraceLogger : public RedisTracer
+{
+protected:
+    FILE* out;
+    mutex mtx;
+
+public:
+    RedisTraceLogger(int slowtime = 10000, double sample = 0, FILE* out = stderr) : out(out)
+    {
+        this->slowtime = slowtime;
+        this->sample = sample;
+    }
+    void trace(const RedisTrace& item)
+    {
+        lock_guard<mutex> lk(mtx);
+
+        fprintf(out, "[REDIS][%s] %s key[%s] code[%d] total[%lldus] pool[%lldus] write[%lldus] firstbyte[%lldus] parse[%lldus] send[%dB] recv[%dB]\n",
+                slowtime > 0 && item.total >= slowtime ? "SLOW" : "SAMPLE", item.command.c_str(), item.key.c_str(), item.code,
+                (long long)(item.total), (long long)(item.poolwait), (long long)(item.write), (long long)(item.firstbyte),
+                (long long)(item.parse), item.sendsz, item.recvsz);
+        fflush(out);
+    }
+};
+//////////////////////////////////////////////////////////////////////////////
+#endif
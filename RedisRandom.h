@@ -0,0 +1,30 @@
+#ifndef   REDISRANDOM_H
+#define   REDISRANDOM_H
+//////////////////////////////////////////////////////////////////////////////
+#include "typedef.h"
+
+#include <chrono>
+
+/**线程内的 xorshift 伪随机数，用于熔断等待时间的抖动和跟踪采样这类不需要密码学强度的场合。
+ * 每个线程有独立的状态，按线程第一次使用时的时间初始化，不加锁。**/
+class RedisRandom
+{
+public:
+    static u_int64 Next()
+    {
+        thread_local u_int64 seed = (u_int64)(std::chrono::steady_clock::now().time_since_epoch().count()) * 0x9E3779B97F4A7C15ULL + 1;
+
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+
+        return seed;
+    }
+    /**[0, 1) 之间均匀分布的浮点数**/
+    static double NextDouble()
+    {
+        return (Next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+//////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,121 @@
+#ifndef   REDISSCAN_H
+#define   REDISSCAN_H
+//////////////////////////////////////////////////////////////////////////////
+#include "typedef.h"
+
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define REDIS_SCAN_SSE2
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define REDIS_SCAN_AVX2
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**RESP 响应的扫描工具：查找行结束符和解析行中的整数。
+ * 编译时启用了 AVX2（-mavx2）时每次比较 32 字节，x86 上默认用 SSE2 每次比较 16 字节，其他平台逐字节比较。
+ * 所有函数只访问 [str, end) 范围内的数据，不要求数据以 '\0' 结尾。**/
+class RedisScan
+{
+protected:
+    static int LowBit(u_int32 mask)
+    {
+#ifdef _MSC_VER
+        unsigned long idx;
+
+        _BitScanForward(&idx, mask);
+
+        return (int)(idx);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+public:
+    /**查找第一个 '\r'，找不到时返回 NULL**/
+    static const char* FindCR(const char* str, const char* end)
+    {
+#ifdef REDIS_SCAN_AVX2
+        const __m256i cr32 = _mm256_set1_epi8('\r');
+
+        while (end - str >= 32)
+        {
+            u_int32 mask = (u_int32)(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(str)), cr32)));
+
+            if (mask) return str + LowBit(mask);
+
+            str += 32;
+        }
+#endif
+#ifdef REDIS_SCAN_SSE2
+        const __m128i cr16 = _mm_set1_epi8('\r');
+
+        while (end - str >= 16)
+        {
+            u_int32 mask = (u_int32)(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(str)), cr16)));
+
+            if (mask) return str + LowBit(mask);
+
+            str += 16;
+        }
+#endif
+        while (str < end)
+        {
+            if (*str == '\r') return str;
+
+            str++;
+        }
+
+        return NULL;
+    }
+    /**查找第一个 "\r\n"，返回 '\r' 的位置，找不到时返回 NULL**/
+    static const char* FindCRLF(const char* str, const char* end)
+    {
+        while ((str = FindCR(str, end)) != NULL)
+        {
+            if (str + 1 >= end) return NULL;
+            if (str[1] == '\n') return str;
+
+            str++;
+        }
+
+        return NULL;
+    }
+    /**解析以 "\r\n" 结尾的十进制整数（长度、元素个数、整数响应），可以有 '-' 号。
+     * 成功时返回 '\r' 的位置，数据不完整时返回 end，格式错误或超出 int64 范围时返回 NULL。
+     * 扫描数字的同时就找到了行结束符，不需要再单独查找。**/
+    static const char* ParseInt(const char* str, const char* end, int64& val)
+    {
+        bool neg = false;
+        u_int64 num = 0;
+
+        if (str < end && *str == '-')
+        {
+            neg = true;
+            str++;
+        }
+
+        const char* head = str;
+
+        while (str < end && (u_char)(*str - '0') < 10)
+        {
+            num = num * 10 + (*str - '0');
+            str++;
+        }
+
+        if (str == end || str + 1 == end) return end;
+        if (str == head || str - head > 19 || str[0] != '\r' || str[1] != '\n') return NULL;
+        if (num > (u_int64)(numeric_limits<int64>::max()) + (neg ? 1 : 0)) return NULL;
+
+        val = neg ? (int64)(0 - num) : (int64)(num);
+
+        return str;
+    }
+};
+//////////////////////////////////////////////////////////////////////////////
+#endif
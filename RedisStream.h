@@ -0,0 +1,248 @@
+#ifndef   REDISSTREAM_H
+#define   REDISSTREAM_H
+//////////////////////////////////////////////////////////////////////////////
+#include <deque>
+#include "Redisconnect_myself.h"
+
+/**消费组的消费者：一个读取线程在独立连接上用 XREADGROUP 阻塞读取消息，分发给工作线程池处理。
+ * 处理成功（handler 返回 true）的消息由读取线程在下一次读取前批量 XACK，
+ * 处理失败或者没来得及处理的消息保留在待确认列表中，空闲超过 claimidle 后由 XAUTOCLAIM 重新领取。
+ * 同一条消息可能被处理多次，handler 需要是幂等的。**/
+class RedisStreamConsumer
+{
+public:
+    typedef function<bool(const RedisStreamEntry&)> Handler;
+
+    struct Option
+    {
+        string key;                 /**流的键**/
+        string group;               /**消费组，不存在时自动创建**/
+        string consumer;            /**消费者名称，同一个消费组中需要唯一**/
+        int threads = 4;            /**工作线程数**/
+        int count = 100;            /**每次读取的最大消息数**/
+        int block = 1000;           /**每次阻塞读取的最长时间（毫秒），也决定了 stop 的最长等待时间**/
+        int64 claimidle = 60000;    /**待确认消息空闲超过这个时间（毫秒）后重新领取，小于等于0表示不领取**/
+        int claiminterval = 30000;  /**检查待确认消息的间隔（毫秒）**/
+    };
+
+protected:
+    Option option;
+    Handler handler;
+    mutex mtx;
+    condition_variable cv;
+    deque<RedisStreamEntry> queue;
+    vector<string> acks;
+    thread reader;
+    vector<thread> workers;
+    atomic<bool> stopped;
+    shared_ptr<RedisConnect> redis;
+
+    atomic<int64> handled;
+    atomic<int64> failed;
+    atomic<int64> claimed;
+
+protected:
+    /**批量确认已经处理成功的消息，连接出错时保留待下次确认**/
+    void flush()
+    {
+        vector<string> vec;
+
+        {
+            lock_guard<mutex> lk(mtx);
+
+            vec.swap(acks);
+        }
+
+        if (vec.empty() || redis == NULL) return;
+
+        if (redis->xack(option.key, option.group, vec) < 0)
+        {
+            lock_guard<mutex> lk(mtx);
+
+            acks.insert(acks.end(), vec.begin(), vec.end());
+        }
+    }
+    void push(vector<RedisStreamEntry>& vec)
+    {
+        if (vec.empty()) return;
+
+        {
+            lock_guard<mutex> lk(mtx);
+
+            for (RedisStreamEntry& item : vec) queue.emplace_back(std::move(item));
+        }
+
+        cv.notify_all();
+    }
+    /**领取空闲超时的待确认消息，每次扫描一轮**/
+    void claim()
+    {
+        string next;
+        string start = "0-0";
+        vector<RedisStreamEntry> vec;
+
+        while (!stopped && redis->xautoclaim(vec, next, option.key, option.group, option.consumer, option.claimidle, start, option.count) >= 0)
+        {
+            claimed += vec.size();
+            push(vec);
+
+            if (next == "0-0" || next.empty()) break;
+
+            start = next;
+        }
+    }
+    void read()
+    {
+        vector<RedisStreamEntry> vec;
+        int64 claimtime = 0;
+
+        while (!stopped)
+        {
+            if (redis == NULL || redis->isBroken())
+            {
+                if ((redis = RedisConnect::Create()) == NULL || redis->xgroupCreate(option.key, option.group, "0") < 0)
+                {
+                    redis = NULL;
+                    Sleep(1000);
+                    continue;
+                }
+            }
+
+            flush();
+
+            if (option.claimidle > 0 && ResPool<RedisConnect>::Now() >= claimtime)
+            {
+                claim();
+                claimtime = ResPool<RedisConnect>::Now() + option.claiminterval;
+            }
+            /**队列中积压的消息过多时暂停读取，只等待工作线程处理**/
+            {
+                unique_lock<mutex> lk(mtx);
+
+                if ((int)(queue.size()) >= option.threads * option.count)
+                {
+                    cv.wait_for(lk, chrono::milliseconds(100));
+                    continue;
+                }
+            }
+
+            if (redis->xreadgroup(vec, option.group, option.consumer, option.key, option.count, option.block) > 0) push(vec);
+        }
+    }
+    void work()
+    {
+        while (true)
+        {
+            RedisStreamEntry item;
+
+            {
+                unique_lock<mutex> lk(mtx);
+
+                cv.wait(lk, [this](){
+                    return stopped || queue.size() > 0;
+                });
+
+                if (queue.empty()) return;
+
+                item = std::move(queue.front());
+                queue.pop_front();
+            }
+
+            cv.notify_all();
+
+            bool res = false;
+
+            try
+            {
+                res = handler(item);
+            }
+            catch (...)
+            {
+                res = false;
+            }
+
+            if (res)
+            {
+                handled++;
+
+                lock_guard<mutex> lk(mtx);
+
+                acks.emplace_back(std::move(item.id));
+            }
+            else
+            {
+                failed++;
+            }
+        }
+    }
+
+public:
+    RedisStreamConsumer(const Option& option, Handler handler) : option(option), handler(handler), stopped(true), handled(0), failed(0), claimed(0)
+    {
+    }
+    ~RedisStreamConsumer()
+    {
+        stop();
+    }
+    /**启动读取线程和工作线程，需要先调用 RedisConnect::Setup**/
+    bool start()
+    {
+        if (!stopped || option.threads <= 0 || !RedisConnect::CanUse()) return false;
+
+        stopped = false;
+
+        for (int i = 0; i < option.threads; i++)
+        {
+            workers.emplace_back([this](){
+                work();
+            });
+        }
+
+        reader = thread([this](){
+            read();
+        });
+
+        return true;
+    }
+    /**停止读取，等待工作线程处理完正在处理的消息后确认，队列中剩余的消息留给 XAUTOCLAIM 恢复**/
+    void stop()
+    {
+        if (stopped) return;
+
+        {
+            lock_guard<mutex> lk(mtx);
+
+            stopped = true;
+        }
+
+        cv.notify_all();
+
+        if (reader.joinable()) reader.join();
+
+        {
+            lock_guard<mutex> lk(mtx);
+
+            queue.clear();
+        }
+
+        for (thread& item : workers) item.join();
+
+        workers.clear();
+        flush();
+        redis = NULL;
+    }
+    int64 getHandled() const
+    {
+        return handled;
+    }
+    int64 getFailed() const
+    {
+        return failed;
+    }
+    int64 getClaimed() const
+    {
+        return claimed;
+    }
+};
+//////////////////////////////////////////////////////////////////////////////
+#endif
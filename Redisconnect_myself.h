@@ -1,1157 +1,3152 @@
-//
-// Created by LZH on 2023/6/28.
-//
-
-/**#ifndef REDISCONNECT_REDISCONNECT_MYSELF_H 是条件预处理指令，用于检查第一个名为 REDISCONNECT_REDISCONNECT_MYSELF_H
- * 的宏是否被定义，如果没有被定义过，也就是第一次包含该头文件，那么下面直到#endif之间的代码将会被编译，且只编译一次
- *
- * #ifndef #endif以外的代码不受限制，可以被多次编译
- **/
-#ifndef REDISCONNECT_REDISCONNECT_MYSELF_H
-#define REDISCONNECT_REDISCONNECT_MYSELF_H
-
-#include "ResPool.h"
-
-/**判断是否linux平台？**/
-#ifdef LINUX
-
-#include "errno.h"
-#include "netdb.h"
-#include "fcntl.h"
-#include "signal.h"
-#include "sys/time.h"
-#include "sys/wait.h"
-#include "sys/stat.h"
-#include "sys/file.h"
-#include "sys/types.h"
-#include "sys/ioctl.h"
-#include "arpa/inet.h"
-#include "sys/epoll.h"
-#include "sys/statfs.h"
-#include "sys/socket.h"
-#include "netinet/in.h"
-#include "sys/syscall.h"
-
-
-
-
-/**?**/
-#define ioctlsocket ioctl
-/**表示无效的socket**/
-#define INVALID_SOCKET (SOCKET)(-1)
-
-typedef int SOCKET;
-#endif
-
-class RedisConnect
-{
-    typedef std::mutex Mutex;
-    typedef std::lock_guard<std::mutex> Locker;
-
-    friend class Command;
-
-public:
-    static const int OK = 1;      /**成功**/
-    static const int FAIL = -1;   /**失败**/
-    static const int IOERR = -2;  /**IO错误**/
-    static const int SYSERR = -3; /***系统错误**/
-    static const int NETERR = -4; /**网络错误？**/
-    static const int TIMEOUT = -5; /**超过时限**/
-    static const int DATAERR = -6;/**日期错误？**/
-    static const int SYSBUSY = -7;/**系统繁忙**/
-    static const int PARAMERR = -8; /**参数错误**/
-    static const int NOTFUND = -9;
-    static const int NETCLOSE = -10; /**网络关闭**/
-    static const int NETDELAY = -11; /**网络延迟**/
-    static const int AUTHFAIL = -12; /**认证失败**/
-
-public:
-    static int POOL_MAXLEN;
-    static int SOCKET_TIMEOUT;
-public:
-    class Socket{
-    protected:
-        SOCKET sock = INVALID_SOCKET;
-
-    public:
-        /**用于检查socket是否处于超时状态**/
-        static bool IsSocketTimeout(){
-#ifdef LINUX
-            /** ==0 表示没有错误
-             * EAGAIN 和 EWOULDBLOCK 在大多数情况下是等价的，表示操作被阻塞，但不是由于错误，可以稍后尝试
-             * EINTR 表示操作被信号中断。当进程收到信号时，正在进行的系统调用可能会被中断
-             * 以上表示当前操作无法完成或已被中断**/
-            return errno == 0 || errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
-#else
-            return WSAGetlastError() == WSAETIMEDOUT;
-#endif
-        }
-        /**SocketClose 函数接受一个套接字 sock 作为参数，并首先调用 IsSocketClosed 函数检查套接字是否已经关闭。
-         * 如果套接字已经关闭，函数直接返回，不做任何操作。否则，它会根据操作系统是 Linux 还是 Windows 执行相应的关闭操作**/
-        static void SocketClose(SOCKET sock){
-            if (IsSocketClosed(sock)) return;
-#ifdef LINUX
-            ::close(sock);
-#else
-            ::closesocket(sock);
-#endif
-        }
-        /**IsSocketClosed 函数接受一个套接字 sock 作为参数，用于检查套接字是否已关闭。**/
-        static bool IsSocketClosed(SOCKET sock){
-            return sock == INVALID_SOCKET || sock < 0;
-        }
-        /**设置套接字（SOCKET）的发送超时时间
-         * SOCKET sock：要设置超时的套接字。
-         * int timeout：超时时间，以毫秒为单位。**/
-        static bool SocketSetSendTimeout(SOCKET sock,int timeout){
-#ifdef LINUX
-            /**struct timeval 结构体，用于表示时间
-             * tv_sec 表示秒数部分，tv_usec 表示微秒部分。
-             * 将传入的 timeout 转换为秒和微秒，并设置到 tv 结构体中。
-             * **/
-            struct timeval tv;
-            tv.tv_sec = timeout / 1000;
-            tv.tv_usec = timeout % 1000 * 1000;
-            /**setsockopt 函数用于设置套接字（Socket）的选项，允许程序员控制套接字的行为。原型如下
-             * int setsockopt(int sockfd, int level, int optname, const void *optval, socklen_t optlen);
-                1）sockfd ：socket文件描述符，用于标识要设置选项的套接字。
-                2）level：选项所属的协议层或套接字类型，通常是 SOL_SOCKET 表示通用套接字选项，也可以是其他协议的特定选项。
-                         常见的协议层包括 SOL_SOCKET（通用套接字选项）、IPPROTO_TCP（TCP 协议选项）、IPPROTO_UDP（UDP 协议选项）等。
-                3）optname: 要设置的选项名称，表示需要修改的具体选项。例如，SO_REUSEADDR 表示允许地址重用，SO_RCVBUF 表示接收缓冲区大小等。
-                4) optval：指向包含选项值的缓冲区的指针。这个缓冲区通常包含一个特定类型的数据，用于设置选项的值。
-                5) optlen：optval 缓冲区的大小，以字节为单位。
-
-             * 将套接字的发送超时设置为 tv 结构体中指定的时间。这样，当调用套接字的发送操作，
-             * 如果发送操作在 timeout 毫秒内未能成功完成，就会返回一个超时错误。
-             * sock  要设置的socket
-             * SO_SNDTIMEO 是要设置的选项名称，它表示发送超时选项，用于设置发送数据时的超时限制。
-             * &tv 是一个指向 timeval 结构体的指针,表示要设置的时间
-             * sizeof 要设置的时间的大小**/
-            return setsockopt(sock,SOL_SOCKET,SO_SNDTIMEO,(char *)(&tv),sizeof(tv)) == 0;
-#else
-            return setsockopt(sock,SOL_SOCKET,SO_SNDTIMEO,(char *)(&timeout),sizeof(timeout)) == 0;
-#endif
-        }
-        /**和上面的差不多，上面是发送超时时间，这个是接收超时时间**/
-        static bool SocketSetRecvTimeout(SOCKET sock,int timeout){
-#ifdef LINUX
-            struct timeval tv;
-            tv.tv_sec = timeout / 1000;
-            tv.tv_usec = timeout % 1000 * 1000;
-
-            return setsockopt(sock,SOL_SOCKET,SO_RCVTIMEO,(char *)(&tv),sizeof(tv)) == 0;
-#else
-            return setsockopt(sock,SOL_SOCKET, SO_RCVTIMEO, (char*)(&timeout), sizeof(timeout)) == 0;
-#endif
-        }
-
-
-
-        /**创建一个socket，设置为非阻塞模式，然后尝试连接到指定的 IP 地址和端口。如果连接成功，
-         * 将socket设置回阻塞模式，并返回套接字。，否则返回 INVALID_SOCKET 表示连接失败。**/
-        SOCKET SocketConnectTimeout(const char * ip,int port,int timeout){
-            u_long mode = 1;
-            /**struct sockaddr_in {
-                short sin_family;      // 地址家族，通常为 AF_INET（IPv4）
-                unsigned short sin_port;  // 端口号，以网络字节序表示（大端字节序）
-                struct in_addr sin_addr;  // IPv4 地址
-                char sin_zero[8];       // 未使用，通常用 0 填充
-            };
-            **/
-            struct sockaddr_in addr;
-            /**socket() 函数是用于创建套接字（socket）的系统调用，它用于在网络编程中创建一个新的通信端点。
-             * 原型如下 int socket(int domain, int type, int protocol);
-             * 1）domain 参数指定了套接字的地址家族（Address Family），
-             *    常见的有：AF_INET：IPv4 地址家族，用于 Internet 地址。AF_INET6：IPv6 地址家族，用于 IPv6 地址。
-             * 2）type 参数指定了套接字的类型，常见的有:SOCK_STREAM：流式套接字，用于 TCP 协议，提供可靠的、面向连接的通信。
-             *                                    SOCK_DGRAM：数据报套接字，用于 UDP 协议，提供不可靠的、无连接的通信。
-                                                  SOCK_RAW：原始套接字，用于直接访问网络协议，通常需要特权。
-               3) protocol 参数指定了要使用的协议，通常可以设置为 0，让系统自动选择合适的协议。
-             **/
-            SOCKET sock = socket(AF_INET,SOCK_STREAM,0);
-
-            if (IsSocketClosed(sock)) return INVALID_SOCKET;
-
-            addr.sin_family = AF_INET;
-            addr.sin_port = htons(port);  /**htons() 函数将主机字节序转换为网络字节序。**/
-            addr.sin_addr.s_addr = inet_addr(ip);  /**将 IP 地址转换为网络字节序并设置到 addr 结构体中。**/
-
-            /**ioctlsocket() 是一个用于控制套接字（socket）行为的函数，通常用于套接字编程中。
-             * 它允许程序员通过一系列的命令来控制套接字的各种属性和行为。
-             * int ioctlsocket(SOCKET s, long cmd, u_long* argp);
-             * s：套接字描述符，要对哪个套接字执行操作。
-               cmd：一个控制命令，指定要执行的操作。
-               argp：一个指向参数的指针，具体参数的类型和意义取决于 cmd。
-
-               在这段代码中，首先将 mode 设置为 1，表示要将套接字设置为非阻塞模式。
-               然后，通过调用 ioctlsocket() 函数，将 FIONBIO 控制命令应用于套接字 sock，以将其设置为非阻塞模式。**/
-            ioctlsocket(sock,FIONBIO,&mode); mode = 0;
-
-
-            /**connect 函数用于在客户端套接字上发起连接到服务器端套接字的请求，建立网络连接。这个函数通常用于创建 TCP 或 UDP 客户端程序。
-             * int connect(int sockfd, const struct sockaddr *addr, socklen_t addrlen);
-                sockfd：要连接的套接字的文件描述符。
-                addr：指向目标服务器端地址信息的指针，通常是 struct sockaddr_in 或 struct sockaddr 类型的指针。sockaddr_in通常用于ipv4
-                addrlen：addr 指向的地址结构体的大小，通常使用 sizeof(struct sockaddr_in) 来获取。
-                返回值：如果连接成功，connect 返回 0。
-                       如果连接失败，它会返回 -1，并设置全局变量 errno 来指示失败的原因。
-                连接过程：
-                        connect 函数会尝试建立与目标服务器的连接。
-                        如果连接成功，套接字现在可以用于发送和接收数据。
-                        如果连接失败，可以使用 errno 来确定失败的原因。
-                阻塞：
-                        默认情况下，connect 函数是阻塞的，它会一直等待连接成功或失败。
-                        如果需要使用非阻塞连接，可以在调用 connect 前将套接字设置为非阻塞模式。
-                错误处理：
-                        如果 connect 返回 -1，你可以使用 errno 来查找失败的原因。
-                        常见的错误包括 ECONNREFUSED（连接被拒绝）、ETIMEDOUT（连接超时）等。**/
-            if (::connect(sock,(struct sockaddr *)(&addr),sizeof(addr)) == 0){
-                ioctlsocket(sock,FIONBIO,&mode);
-                return sock;
-            }
-#ifdef LINUX
-
-            /**如果connect连接失败，执行下列操作
-             * 针对 Linux，该代码创建了一个 epoll 实例，
-             * 并将套接字添加到 epoll 集合中，关注 EPOLLOUT、EPOLLERR 和 EPOLLHUP 事件。
-             * 使用 epoll_wait() 函数等待套接字就绪，如果在超时时间内有事件发生，且其中包含
-             * EPOLLOUT 事件，那么说明连接成功，获取套接字错误状态并将套接字重新设置为阻塞模式，然后返回该套接字。
-             */
-            struct epoll_event ev;
-            struct epoll_event evs;
-            /**创建了一个 epoll 实例,原型如下
-             * int epoll_create(int size);
-            用于指定 epoll 实例的大小，但在现代的 Linux 内核中，这个参数已经不再使用，通常可以设置为任意正数。
-             **/
-            int handle = epoll_create(1);
-            /**创建失败，它会关闭套接字并返回 INVALID_SOCKET**/
-            if (handle < 0){
-                SocketClose(sock);
-
-                return INVALID_SOCKET;
-            }
-            /** 用于将 ev 结构体的内存清零，以确保没有未初始化的数据。**/
-            memset(&ev,0, sizeof(ev));
-            /**events字段用于表示文件描述符上发生的事件。
-             * EPOLLIN：文件描述符可读（有数据可读取）。
-                EPOLLOUT：文件描述符可写（可以发送数据）。           EPOLLOUT 的二进制表示是 00000001，只有最低位是1。
-                EPOLLERR：文件描述符上有错误发生。                   EPOLLERR 的二进制表示是 00000010，只有次低位是1。
-                EPOLLHUP：文件描述符的挂起事件（通常表示连接已关闭）。  EPOLLHUP 的二进制表示是 00000100，只有第三位是1
-                得到二进制表示 00000111，这意味着同时设置了这三个标志位。
-                然后，在检查事件时，你可以使用按位与操作来测试特定的标志位是否设置，以确定哪些事件已经发生。**/
-            ev.events = EPOLLOUT | EPOLLERR | EPOLLHUP;
-            /** epoll_ctl 是 Linux 下用于控制 epoll 实例的函数之一，它主要用于向 epoll 实例中添加、修改或删除文件描述符以及关联的事件。
-             * int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
-               1）epfd：表示要进行操作的 epoll 实例的文件描述符。
-               2）op：表示操作类型，可以是以下几种值之一：
-                    EPOLL_CTL_ADD：将文件描述符 fd 添加到 epoll 实例中，以监视 event 中指定的事件。
-                    EPOLL_CTL_MOD：修改已经添加到 epoll 实例的文件描述符 fd 的事件监视设置。
-                    EPOLL_CTL_DEL：从 epoll 实例中删除文件描述符 fd，停止监视该文件描述符上的事件。
-               3）fd：表示要添加、修改或删除的文件描述符。
-               4）event：一个指向 struct epoll_event 结构的指针，用于指定要监视的事件类型以及与事件相关的数据。
-
-             * 告诉 epoll 实例 handle 开始监视套接字 sock 上的特定事件，这些事件在 ev 结构中指定。
-             * 一旦套接字上发生了这些事件中的任何一个，你将能够通过 epoll_wait 等函数获得通知，并采取适当的操作。
-             * ev 结构初始化为监视以下事件：
-                EPOLLOUT：当socket准备好写入数据时触发此事件，通常用于非阻塞套接字以避免写入阻塞。
-                EPOLLERR：当socket上发生错误时触发此事件，例如连接重置。
-                EPOLLHUP：当socket的挂起或关闭事件发生时触发此事件。
-                一旦调用 epoll_ctl 成功，并将套接字添加到 epoll 实例中，你可以使用 epoll_wait 函数来等待发生这些事件，然后采取适当的处理步骤。**/
-            epoll_ctl(handle,EPOLL_CTL_ADD,sock,&ev);
-
-            /**epoll_wait 是 Linux 下用于等待事件发生的函数，
-             * int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout);
-                epfd：表示要等待事件的 epoll 实例的文件描述符。
-                events：一个指向 struct epoll_event 数组的指针，用于存储发生了的事件的类型 events字段 以及相关的事件信息  data字段。
-                maxevents：表示 events 数组的大小，即最多可以存储多少个事件。
-                timeout：指定等待事件的超时时间，单位是毫秒。如果设置为 -1，则表示无限等待，直到有事件发生。如果设置为 0，则表示立即返回，不等待事件。
-
-             * 用于等待事件的发生，最多等待 timeout 毫秒。如果在超时时间内发生了事件，它会将事件信息存储在 evs 中。
-             * 检查返回值来判断是否发生了事件，如果返回大于 0，表示至少有一个事件发生；如果返回等于 0，表示超时；如果返回小于 0，表示出现了错误。
-             * 阻塞模式：如果你将 epoll_wait 的 timeout 参数设置为一个非负数，例如 timeout 大于 0，那么 epoll_wait 将会以阻塞模式工作。
-             * 它会等待指定的时间（以毫秒为单位）直到发生事件或者超时才返回。在这种模式下，如果没有事件发生，epoll_wait 会一直阻塞当前线程，直到有事件发生或者超时。
-               非阻塞模式：如果你将 epoll_wait 的 timeout 参数设置为 0（或者更准确地说，设置为负数），那么 epoll_wait 将会以非阻塞模式工作。
-               在这种模式下，它会立即返回，不会等待事件发生，而是立即告诉你当前没有事件发生。**/
-            if (epoll_wait(handle,&evs,1,timeout) > 0){
-                /**检查 evs.events 中是否包含 EPOLLOUT 事件,按位与，若包含，说明可写入，即连接成功**/
-                if (evs.events & EPOLLOUT){
-                    int res = FAIL;
-
-                    socklen_t len = sizeof(res);
-                    /**用于获取套接字选项值的函数，它用于查询套接字的特定属性或状态信息.
-                     * sockfd：要查询选项的套接字文件描述符。
-                    level：选项的级别，通常是 SOL_SOCKET（表示套接字级别选项）或其他协议级别。
-                    optname：要查询的选项的名称，例如 SO_ERROR。
-                    optval：用于存储选项值的缓冲区，通常是一个指向合适数据类型的指针。
-                    optlen：输入输出参数，表示 optval 缓冲区的大小，同时也表示成功获取的选项值的大小。
-
-                     是获取套接字的错误状态。例如，通过指定 optname 为 SO_ERROR，可以获取套接字的错误状态，通常用于检查套接字连接操作的结果。**/
-                    getsockopt(sock,SOL_SOCKET,SO_ERROR,(char *)(&res),&len);
-                    /**将套接字重新设置为阻塞模式。**/
-                    ioctlsocket(sock,FIONBIO,&mode);
-                    /**如果为0，表示连接成功，然后关闭 epoll 实例并返回套接字。**/
-                    if (res == 0){
-                        ::close(handle);
-
-                        return sock;
-                    }
-                }
-            }
-
-            ::close(handle);
-#else
-            struct timeval tv;
-
-			fd_set ws;
-			FD_ZERO(&ws);
-			FD_SET(sock, &ws);
-
-			tv.tv_sec = timeout / 1000;
-			tv.tv_usec = timeout % 1000 * 1000;
-
-			if (select(sock + 1, NULL, &ws, NULL, &tv) > 0)
-			{
-				int res = ERROR;
-				int len = sizeof(res);
-
-				getsockopt(sock, SOL_SOCKET, SO_ERROR, (char*)(&res), &len);
-				ioctlsocket(sock, FIONBIO, &mode);
-
-				if (res == 0) return sock;
-			}
-
-#endif
-            /***如果运行到了这里说明没有socket没有连接成功，关闭sock，返回INVALID_SOCKET**/
-            SocketClose(sock);
-            return INVALID_SOCKET;
-        }
-
-
-    public:
-        /**关闭socket**/
-        void close(){
-            SocketClose(sock);
-            sock = INVALID_SOCKET;
-        }
-        /**const 的作用是确保函数不会修改类的内部状态，即不会修改 sock 这个成员变量的值。**/
-        bool isClosed() const{
-            return IsSocketClosed(sock);
-        }
-        /**设置发送超时时间**/
-        bool setSendTimeout(int timeout){
-            return SocketSetSendTimeout(sock,timeout);
-        }
-        /**设置接收超时**/
-        bool setRecvTimeout(int timeout){
-            return SocketSetRecvTimeout(sock,timeout);
-        }
-
-        bool connect(const std::string & ip,int port,int timeout){
-            close();
-            sock = SocketConnectTimeout(ip.c_str(),port,timeout);
-            return IsSocketClosed(sock) ? false : true;
-        }
-
-    public:
-        /**将data中的数据写入socket**/
-        int write(const void * data,int count){
-            const char * str = (const char *)(data);
-            int num = 0;    /**记录每次发送的字节数**/
-            int times = 0;  /**发送发送成功但一次发送字节数小于等于8的次数**/
-            int writed = 0; /**已成功发送的字节数**/
-
-            while (writed < count){
-                /**send() 函数是用于在socket上发送数据的函数。
-                 * ssize_t send(int sockfd, const void *buf, size_t len, int flags);
-                    sockfd：套接字文件描述符，指定要发送数据的套接字。
-                    buf：要发送的数据的缓冲区地址。
-                    len：要发送的数据的长度（以字节为单位）。
-                    flags：用于指定发送操作的标志，通常可以设置为0。
-
-                    send() 函数的返回值是已发送的字节数，如果出现错误则返回-1。
-                    send() 函数通常用于阻塞式套接字（默认情况下）。如果套接字是非阻塞的，它可以在没有足够数据发送时立即返回，
-                    并且返回值可能小于请求发送的数据长度。在非阻塞套接字上使用 send() 时需要谨慎处理返回值，因为需要检查返回值以确定实际发送了多少数据。
-                **/
-                /**将data中的数据写入到socket，每次从str+writed开始写**/
-                if ((num = send(sock,str+writed,count-writed,0)) > 0){
-                    if (num > 8){
-                        times = 0;
-                    } else{
-                        if (++times > 100) return TIMEOUT;
-                    }
-
-                    writed += num;
-                } else{
-                    if (IsSocketTimeout()){
-                        if (++times > 100) return TIMEOUT;
-                        continue;
-                    }
-                    return NETERR;
-                }
-            }
-
-            return writed;
-        }
-        /**从socket中读取数据，基本同上，有两种读取模式，completed和非completed**/
-        int read(void * data,int count,bool completed){
-            char * str = (char *)(data);
-            if (completed){
-                int num = 0;
-                int times = 0;
-                int readed = 0;
-
-                while (readed < count){
-                    /**recv() 是一个用于从套接字（Socket）接收数据的系统调用（函数）。它通常用于网络编程中，用于接收数据报文或消息。
-                     * int recv(int sockfd, void *buf, size_t len, int flags);
-                        sockfd：表示要接收数据的套接字文件描述符。
-                        buf：指向存储接收数据的缓冲区的指针。
-                        len：指定要接收的数据的最大长度。
-                        flags：指定接收数据的附加选项，通常可以设置为 0。
-                        返回值 如果 recv() 返回值大于 0，则表示成功接收了指定数量的字节数据。
-                              如果 recv() 返回值等于 0，表示对端（通常是远程服务器）已经关闭了连接。
-                              如果 recv() 返回值为 -1，表示发生了错误，此时可以使用 errno 全局变量获取错误码，以进一步确定错误的原因。
-
-                     **/
-                     /**将socket中的数据写入str+readed**/
-                    if ((num = recv(sock,str+ readed,count-readed,0)) > 0){
-                        if (num > 8){
-                            times = 0;
-                        } else{
-                            if (++times > 100){
-                                return TIMEOUT;
-                            }
-                        }
-                        readed += num;
-                    } else if (num==0){
-                        return NETCLOSE;
-                    } else{
-                        if (IsSocketTimeout()){
-                            if (++times > 100) return TIMEOUT;
-                            continue;
-                        }
-                        return NETERR;
-                    }
-                }
-                return readed;
-            } else{
-                int val = recv(sock,str,count,0);
-                if (val > 0) return val;
-                if (val == 0) return NETCLOSE;
-                if (IsSocketTimeout()) return 0;
-
-                return NETERR;
-            }
-        }
-    };
-
-    class Command {
-        friend RedisConnect;
-
-    protected:
-        int status;
-        std::string msg;
-        vector<string> res;
-        vector<string> vec;
-
-    protected:
-        int parse(const char * msg,int len){
-            /**以 $ 开头，表示它是一个批定长度的字符串。它会调用 parseNode 函数来解析字符串，
-             * 并根据解析的结果返回相应的状态码（如 OK、TIMEOUT、NOTFUND）。
-             *
-             * get命令会返回  "$9\r\nlzh111111\r\n"**/
-            if (*msg == '$'){
-                const char * end = parseNode(msg,len);
-
-                if (end == NULL) return DATAERR;
-
-                switch (end - msg) {
-                    case 0 : return TIMEOUT;
-                    case -1: return NOTFUND;
-                }
-
-                return OK;
-            }
-            /**跳过resp协议规定的首字符如$ + - :*/
-            const char * str = msg + 1;
-            /**返回"\r\n"首次出现的位置**/
-            const char * end = strstr(str,"\r\n");
-            /**如果无法找到结束标记，返回原始的 msg，表示解析失败。**/
-            if (end == NULL) return TIMEOUT;
-            /**如果消息以 +、- 或 : 开头，表示它是一个状态回复，通常用于表示成功、失败或状态码。
-             * 根据消息的前缀字符，它设置相应的状态码和消息内容。**/
-            if (*msg == '+' || *msg == '-' || *msg == ':'){
-                this->status = OK;
-                /**截取除了首字符以及结尾的"\r\n"之间的字符串***/
-                this->msg = string(str,end);
-
-                if (*msg == '+') return OK;
-                if (*msg == '-') return FAIL;
-
-                this->status = atoi(str);
-
-                return OK;
-            }
-
-
-            /**消息以 "*" 开头，表示这是一个多行回复，通常用于表示多个元素的数组。它解析数组的元素数量，然后循环处理每个元素。
-             * 每个元素都以 "$" 开头，后面跟着元素的长度。parseNode 被用来解析每个元素。解析完成后，它返回数组的长度。
-             * 一般数组元素中都是字符串，所以用parseNode解析数组内元素**/
-            if (*msg == '*'){
-                /**查看数组中有几个元素**/
-                int cnt = atoi(str);
-                /**标记 RESP 响应字符串的末尾，以确保不超出字符串的长度。**/
-                const char * tail = msg +len;
-                /**因为是数组，所以返回有多个，用vec存储**/
-                vec.clear();
-                /**移动到数组中第一个元素的位置**/
-                str = end + 2;
-                /**遍历解析数组中元素**/
-                while (cnt > 0){
-                    /**如果这个元素还是数组，递归解析**/
-                    if (*str == '*') return parse(str,tail-str);
-
-                    end = parseNode(str,tail- str);
-                    if (end == NULL) return DATAERR;
-                    if (end == str)  return TIMEOUT;
-
-                    str = end;
-                    cnt--;
-                }
-                return res.size();
-            }
-            return DATAERR;
-        }
-        /**用于解析 RESP 响应中的字符串节点。**/
-        const char * parseNode(const char * msg , int len){
-            /**跳过resp协议规定的首字符如$ + - :*/
-            const char * str = msg + 1;
-            /**用于在一个字符串中查找另一个字符串，并返回第一次出现匹配的子字符串的指针。**/
-            const char * end = strstr(str,"\r\n");
-            /**如果无法找到结束标记，返回原始的 msg，表示解析失败。**/
-            if (end == NULL) return msg;
-            /**字符串的长度**/
-            int sz = atoi(str);
-            /**sz 为负数时，表示它是一个引用，msg + sz 实际上是指向之前出现的元素，而不是当前元素。这样可以有效地减少数据传输时的冗余。**/
-            if (sz < 0) return msg + sz;
-            /*第一个元素起始位置***/
-            str = end + 2;
-            /**结束位置**/
-            end = str + sz + 2;
-            /**如果 RESP 响应的长度超出了给定的数据长度 len，返回原始的 msg，表示解析失败。**/
-            if (msg + len < end) return msg;
-            /**将成功解析的 RESP 字符串内容存入 res**/
-            res.emplace_back(string(str,str + sz));
-
-            return end;
-        }
-    public:
-        Command(){
-            this->status = 0;
-        }
-        Command(const string & cmd){
-            vec.emplace_back(cmd);
-            this->status = 0;
-        }
-        void add(const char * val){
-            vec.emplace_back(val);
-        }
-        void add(const string & val){
-            vec.emplace_back(val);
-        }
-
-        /**调用上面那个**/
-        template<class DATA_TYPE>
-        void add(DATA_TYPE val){
-            add(to_string(val));
-        }
-
-        /**递归调用 每次传入的参数中去掉了第一个参数 val**/
-        template<class DATA_TYPE,class ...ARGS>
-        void add(DATA_TYPE val,ARGS ...args){
-            add(val);
-            add(args...);
-        }
-
-    public:
-        /**toString 函数，用于将一组字符串转换为符合 Redis 协议的字符串表示形式。**/
-        string toString() const{
-            /**ostringstream 对象 out，它用于构建最终的字符串表示形式。**/
-            ostringstream out;
-            /**添加一个表示命令参数数量的头部，例如，如果 vec 中有3个参数，头部将是 *3\r\n。**/
-            out << "*" << vec.size() << "\r\n";
-            /**对于 vec 中的每个字符串参数，执行以下步骤：
-                添加一个表示字符串长度的标识符，例如，如果字符串的长度是10，标识符将是 $10\r\n。
-                添加字符串的实际内容，然后添加 \r\n 表示字符串的结束。
-             **/
-            for (const string & item : vec) {
-                out << "$" << item.length() << "\r\n" << item << "\r\n";
-            }
-            return out.str();
-        }
-
-        string get(int idx) const{
-            return res.at(idx);
-        }
-
-        const vector<string> & getDataList() const{
-            return res;
-        }
-
-        int getResult(RedisConnect * redis,int timeout){
-            /**lambda函数，执行redis命令**/
-            auto doWork = [&](){
-                /**toString获取redis命令
-                 * get命令    "*2\r\n$3\r\nget\r\n$5\r\nname2\r\n"
-                 * set命令   ""*3\r\n$3\r\nset\r\n$4\r\nname\r\n$9\r\nlzh111111\r\n""
-                 * 删除锁的命令 "*5\r\n$4\r\neval\r\n$93\r\nif redis.call('get',KEYS[1])==ARGV[1] then return redis.call('del',KEYS[1]) else return 0 end\r\n$1\r\n1\r\n$6\r\nlockey\r\n$26\r\n172.20.123.254:51235:51235\r\n"**/
-                string msg = toString();
-                /**获取socket连接**/
-                Socket & sock = redis->sock;
-                /**将命令字符串 msg 写入到与 Redis 服务器的socket连接中，如果写入失败（返回值小于 0），则返回 NETERR，表示网络错误。**/
-                if (sock.write(msg.c_str(),msg.length()) < 0) return NETERR;
-
-                int len = 0;           /**用于存储读取的数据长度**/
-                int delay = 0;         /**用于记录超时时间**/
-                int readed = 0;        /**用于记录已读取的数据长度**/
-                char * dest = redis->buffer;  /**用于存储接收的数据**/
-                const int maxsz = redis->memsz;
-                /**确保没有读取超出指定最大长度的数据**/
-                while (readed < maxsz){
-                    /**从连接中读取数据，并将读取的数据存储到 dest 缓冲区中，
-                     * dest中本身是可能有数据的，read后会覆盖dest到dest+len的数据，但是dest+len+1处可能还有字符，下面的dest[readed += len] = 0;就是在len+1处添加\0符号，终止**/
-                    if ((len = sock.read(dest+readed,maxsz- readed, false)) < 0) return len;
-                    /**表示暂时没有数据可读,增加 delay，若delay > timeout。说明超时，返回 TIMEOUT 表示响应超时**/
-                    if (len == 0){
-                        delay +=  SOCKET_TIMEOUT;
-                        if (delay > timeout) return TIMEOUT;
-                    } else{
-                        /**终止符***/
-                        dest[readed += len] = 0;
-                        /**将读取到的数据传递给 parse 函数来解析响应数据,将数据存入res中。如果 parse 函数返回 TIMEOUT，表示需要继续等待更多数据。**/
-                        if ((len = parse(dest,readed)) == TIMEOUT){
-                            delay = 0;
-                        } else{
-                            return len;
-                        }
-                    }
-                }
-                return PARAMERR;
-        };
-            /**重置cmd的status和msg**/
-            status = 0;
-            msg.clear();
-            redis->code = doWork();
-            /**redis->code 小于 0说明出问题了  若执行成功，cmd.msg不会为空，会在dowork中的parse里设置**/
-            if (redis->code < 0 && msg.empty()){
-                switch (redis->code) {
-                    case SYSERR:
-                        msg = "system error";
-                        break;
-                    case NETERR:
-                        msg = "network error";
-                        break;
-                    case DATAERR:
-                        msg = "protocol error";
-                        break;
-                    case TIMEOUT:
-                        msg = "response timeout";
-                        break;
-                    case NOTFUND:
-                        msg = "element not found";
-                        break;
-                    default:
-                        msg = "unknown error";
-                }
-            }
-
-            redis->status = status;
-            redis->msg = msg;
-
-
-            return redis->code;
-    };
-
-
-
-
-};
-
-protected:
-    /**code 通常用来表示具体的执行结果或错误码。在 RedisConnect 类中，code 变量用于存储执行命令或操作的返回状态码，
-     * 例如成功执行时可能是 0，不同的错误情况可能对应不同的非零状态码。这个状态码可以帮助开发人员判断具体执行过程中是否出现了问题。**/
-    int code = 0;   /**错误代码**/
-    int port = 0;   /**redis服务器端口号**/
-    int memsz = 0;  /**缓存数据的内存大小**/
-    /**status 变量通常用于表示一个更宽泛的状态或标志，它可能不是具体的数字错误码。在 RedisConnect 类中，status
-     * 变量可能表示连接状态或操作状态的标志，比如是否成功连接到 Redis 服务器、是否成功获取分布式锁等。这个状态通常是布尔值或枚举类型，
-     * 更容易理解操作的成功与否。**/
-    int status = 0; /**连接状态**/
-    int timeout = 0;/**超时时间**/
-    char * buffer = NULL; /**数据缓冲区**/
-
-    string msg;      /**错误信息**/
-    string host;     /**服务器主机**/
-    Socket sock;     /**socket**/
-    string passwd;   /**密码**/
-
-public:
-    ~RedisConnect(){
-        close();
-    }
-
-public:
-    /**获取连接状态**/
-    int getStatus() const{
-        return status;
-    }
-//    获取错误代码。
-    int getErrorCode() const{
-        if (sock.isClosed()) return FAIL;
-        return code < 0 ? code : 0;
-    }
-//    获取错误消息。
-    string getErrorString() const{
-        return msg;
-    }
-
-public:
-    /**关闭连接并释放资源。
-    该方法用于关闭与 Redis 服务器的socket，同时释放内存资源。如果之前分配了缓冲区，也会释放缓冲区。**/
-    void close(){
-        if (buffer){
-            delete[] buffer;
-            buffer = NULL;
-        }
-        sock.close();
-    }
-    /**重新连接到 Redis 服务器。
-     * 如果成功重新连接并进行身份验证（如果设置了密码），则返回true；否则，返回false。**/
-    bool reconnect(){
-        if (host.empty()) return false;
-
-        return connect(host,port,timeout,memsz) && auth(passwd) > 0;
-    }
-    /**执行 Redis 命令并返回执行结果。**/
-    int execute(Command & cmd){
-        return cmd.getResult(this,timeout);
-    }
-    /**同上
-     * val：表示要执行的 Redis 命令的参数。
-        args...：可选的额外参数。
-
-        ...args 表示将参数包 args 展开成单独的参数。
-        args... 表示将多个参数打包成一个参数包。**/
-    template<class DATA_TYPE,class ...ARGS>
-    int execute(DATA_TYPE val,ARGS ...args){
-        /**初始化一个Command对象**/
-        Command cmd;
-        /**将参数不断地放入cmd对象中的vec中["set","name","lzh111111"]**/
-        cmd.add(val,args...);
-
-        return cmd.getResult(this,timeout);
-    }
-    /**同上上
-     * vec：一个字符串向量，用于存储命令的执行结果。
-        val：表示要执行的 Redis 命令的参数。
-        args...：可选的额外参数。**/
-    template<class DATA_TYPE, class ...ARGS>
-    int execute(vector<string>& vec, DATA_TYPE val, ARGS ...args)
-    {
-        Command cmd;
-
-        cmd.add(val, args...);
-
-        cmd.getResult(this, timeout);
-
-        if (code > 0) std::swap(vec, cmd.res);
-
-        return code;
-    }
-    /**用于连接到指定的主机和端口，并进行一些初始化操作。**/
-    bool connect(const string & host,int port,int timeout = 3000,int memsz = 2 * 1024 * 1024){
-        /**首先调用 close() 函数来关闭可能已经存在的连接。**/
-        close();
-        /**如果连接成功，进行后续操作**/
-        if (sock.connect(host,port,timeout)){
-            /**设置发送/接收超时时间**/
-            sock.setSendTimeout(SOCKET_TIMEOUT);
-            sock.setRecvTimeout(SOCKET_TIMEOUT);
-            /**设置host，port,缓冲区大小，超时时间，缓冲区**/
-            this->host = host;
-            this->port = port;
-            this->memsz = memsz;
-            this->timeout = timeout;
-            this->buffer = new char [memsz + 1];
-        }
-        /**若缓冲区申请成功，说明连接成功**/
-        return buffer ? true: false;
-    }
-
-public:
-    int ping(){
-        return execute("ping");
-    }
-
-    int del(const string & key){
-        return execute("del",key);
-    }
-
-    int ttl(const string & key){
-        return execute("ttl",key) == OK ? status : code;
-    }
-
-    int hlen(const string & key){
-        return execute("hlen",key) == OK ? status : code;
-    }
-    /**密码登录**/
-    int auth(const string & passwd){
-        this->passwd = passwd;
-        /**空密码就说明没有密码，登录成功**/
-        if (passwd.empty()) return OK;
-        return execute("auth",passwd);
-    }
-
-    int get(const string & key,string & val){
-        vector<string> vec;
-
-        if (execute(vec,"get",key) < 0) return code;
-        val = vec[0];
-        return code;
-    }
-
-    int decr(const string& key, int val = 1)
-    {
-        return execute("decrby", key, val);
-    }
-
-    int incr(const string& key, int val = 1)
-    {
-        return execute("incrby", key, val);
-    }
-
-    int expire(const string& key, int timeout)
-    {
-        return execute("expire", key, timeout);
-    }
-    /**返回所有 key，返回的key存放在vec中**/
-    int keys(vector<string>& vec, const string& key)
-    {
-        return execute(vec, "keys", key);
-    }
-    /**哈希数据删除field**/
-    int hdel(const string& key, const string& field)
-    {
-        return execute("hdel", key, field);
-    }
-    /**哈希数据获取field对应的value**/
-    int hget(const string& key, const string& field, string& val)
-    {
-        vector<string> vec;
-
-        if (execute(vec, "hget", key, field) <= 0) return code;
-
-        val = vec[0];
-
-        return code;
-    }
-
-    /**设置key，根据timout执行 setex还是set**/
-    int set(const string & key,const string & val,int timeout = 0){
-        return timeout > 0 ? execute("setex",key,timeout,val) : execute("set",key,val);
-    }
-    /**哈希数据设置field与对应的value**/
-    int hset(const string & key,const string & field,const string & val){
-        return execute("hset",key,field,val);
-    }
-
-public:
-    /**列表数据删除，弹出数据，调用lpop，也就是左边弹出**/
-    int pop(const string & key,string & val){
-        return lpop(key,val);
-    }
-    /**列表左弹出**/
-    int lpop(const string & key,string & val){
-        vector<string> vec;
-        if (execute(vec,"lpop",key) <= 0) return code;
-        val = vec[0];
-        return code;
-    }
-    /**列表右弹出**/
-    int rpop(const string& key, string& val)
-    {
-        vector<string> vec;
-
-        if (execute(vec, "rpop", key) <= 0) return code;
-
-        val = vec[0];
-
-        return code;
-    }
-    /**列表数据增加，添加数据**/
-    int pust(const string & key,const string & val){
-        return rpush(key,val);
-    }
-    /**左添加**/
-    int lpush(const string & key,const string & val){
-        return execute("lpush",key,val);
-    }
-    /**右添加**/
-    int rpush(const string & key,const string & val){
-        return execute("rpush",key,val);
-    }
-    /**列表数据查看，start与end之间的数据，左闭右闭**/
-    int range(vector<string> & vec,const string & key,int start,int end){
-        return execute(vec,"lrange",key,start,end);
-    }
-    /**lrange**/
-    int lrange(vector<string> & vec,const string & key,int start,int end){
-        return execute("lrange",key,start,end);
-    }
-
-public:
-    /**有序数组删除**/
-    int zrem(const string & key,const string & field){
-        return execute("zrem",key,field);
-    }
-
-    int zadd(const string & key,const string & field,int score){
-        return execute("zadd",key,score,field);
-    }
-
-    int zrange(vector<string> & vec,const string & key,int start,int end,bool withsore = false){
-        return withsore ? execute(vec,"zrange",key,start, end,"withscores") : execute(vec,"zrange",key,start,end);
-    }
-public:
-    /**这个重载用于执行 Lua 脚本，而不涉及键（KEYS）和参数（ARGV）数组。这是一个最基本的执行 Lua 脚本的方式。**/
-    template<class ...ARGS>
-    int eval(const string & lua){
-        vector<string> vec;
-        return eval(lua,vec);
-    }
-
-    /**调用下面的eval
-     * 这个重载允许执行 Lua 脚本，并传递一个键（KEYS[1]）和参数（ARGV[1]）给 Lua 脚本。在这种情况下，key 是唯一的键，args 可以是零个或多个附加参数。**/
-    template<class ...ARGS>
-    int eval(const string & lua,const string & key,ARGS ...args){
-        vector<string> vec;
-        vec.emplace_back(key);
-        return eval(lua,vec,args...);
-    }
-    /**调用下面的eval
-     * 这个重载允许执行 Lua 脚本，并传递一个键数组（KEYS）以及参数（ARGV）给 Lua 脚本。这样可以传递多个键，也可以传递零个或多个附加参数。**/
-    template<class ...ARGS>
-    int eval(const string & lua,const vector<string> & keys,ARGS ...args){
-        vector<string> vec;
-        return eval(vec,lua,keys,args...);
-    }
-    /**这个重载是最通用的，它允许传递自定义的键数组和参数到 Lua 脚本，并将执行结果存储在 vec 中。**/
-    template<class ...ARGS>
-    int eval(vector<string> & vec,const string & lua,const vector<string> & keys,ARGS ...args){
-        int len = 0;
-        Command cmd("eval");
-        cmd.add(lua);
-        cmd.add(len = keys.size());
-//        int len1 = cmd.vec.size();
-
-        if (len-- > 0){
-            for (int i = 0; i < len; ++i) {
-                cmd.add(keys[i]);
-            }
-            /**之所以这么写，是因为add()没有单独添加额外参数的重载形式，
-             * 调用void add(DATA_TYPE val,ARGS ...args){**/
-            cmd.add(keys.back(),args...);
-        }
-//        len1 = cmd.vec.size();
-
-        cmd.getResult(this,timeout);
-        if (code > 0) swap(vec,cmd.res);
-
-        return code;
-    }
-
-    string get(const string & key){
-        string res;
-        get(key,res);
-        return res;
-    }
-
-    string hget(const string & key,const string & field){
-        string res;
-        hget(key,field,res);
-        return res;
-    }
-
-    const char * getLockId() {
-        /**定义了一个线程局部的字符数组id，用于存储锁的唯一标识符。
-         * 使用 thread_local 保证了锁的唯一标识符对于每个线程是独立的，避免了线程之间的竞争和冲突。**/
-        thread_local char id[0xFF] = {};
-        auto GetHost = []() {
-            char hostname[0xFF];
-            /**获取当前主机的名称，存储在hostname中**/
-            if (gethostname(hostname, sizeof(hostname)) < 0) return "unkonw host";
-            /**根据主机名获取主机的IP地址信息，存储在data中。通常用于进行网络编程中的主机名解析。
-             * gethostbyname() 函数返回一个 struct hostent 结构指针，其中包含了与指定主机名相关的信息，包括 IP 地址。这个结构通常包括以下字段：
-                h_name：官方主机名。                               "Present"
-                h_aliases：主机的别名列表。
-                h_addrtype：地址类型（通常为 AF_INET，表示 IPv4）。   2
-                h_length：地址的字节数。                            4
-                h_addr_list：主机的 IP 地址列表。通常，IP 地址以二进制形式表示，可以通过 inet_ntoa() 函数将其转换为字符串。
-             **/
-            struct hostent *data = gethostbyname(hostname);
-            /**将IP地址转换为字符串格式，返回主机的IP地址。**/
-            return (const char *) inet_ntoa(*(struct in_addr *) (data->h_addr_list[0]));
-        };
-
-        if (*id == 0){
-#ifdef LINUX
-            /**将主机名（或IP地址）、当前进程ID和当前线程ID等信息格式化成一个字符串，并将其存储在id中。这个字符串将作为锁的唯一标识符。**/
-            snprintf(id, sizeof(id)-1,"%s:%ld:%ld",GetHost(),(long)getpid(),(long) syscall(SYS_gettid));
-#else
-            snprintf(id, sizeof(id) - 1, "%s:%ld:%ld", GetHost(), (long)GetCurrentProcessId(), (long)GetCurrentThreadId());
-#endif
-        }
-        return id;
-    }
-    /**
-    这段代码是用来实现分布式锁的解锁操作。解锁的关键在于确保只有持有锁的客户端才能够释放锁，而其他客户端不能随意释放锁。
-
-    通过 Lua 脚本执行 Redis 命令。
-
-    redis.call 是 Redis Lua 脚本中的一个内建函数，用于调用 Redis 命令。在 Lua 脚本中，可以使用 redis.call 来执行 Redis 命令，
-     就像在普通的 Redis 命令行中执行一样。例如redis.call('get', 'mykey')。这允许你在 Lua 脚本中利用 Redis 数据存储和处理的能力。
-
-     KEYS 是 Lua 脚本中的一个特殊数组，用于表示传递给 Lua 脚本的 Redis 键。在 Redis Lua 脚本中，
-     KEYS 数组允许你引用传递给脚本的 Redis 键（key）。KEYS 数组的索引从 1 开始。
-     在这里KEYS[1] 的含义是使用传递给脚本的第一个 Redis 键，通常在解锁分布式锁的情况下，KEYS[1] 将包含用于加锁的键。通过使用 KEYS[1]，
-     你可以在 Lua 脚本中引用和操作这个键，例如检查它的值是否与你期望的值相匹配，然后执行相应的操作，例如删除该键。
-
-     ARGV 是 Lua 脚本中的另一个特殊数组，用于表示传递给 Lua 脚本的参数。与 KEYS 数组类似，ARGV 允许你引用传递给脚本的参数。
-     同样，Lua 数组的索引从 1 开始。
-     在你的 Lua 脚本中，ARGV[1] 表示使用传递给脚本的第一个参数，即数组的第一个元素。通常情况下，ARGV[1] 包含了用于解锁分布式锁的信息，
-     通常是加锁时设置的标识，以确保只有持有相同标识的客户端才能成功解锁。
-
-    通过这个 Lua 脚本，只有持有锁的客户端才能够成功解锁，其他客户端无法释放锁。这是一种非常安全且保证锁的一致性的解锁方式。
-     **/
-    bool unlock(const string & key){
-        const char * lua  = "if redis.call('get',KEYS[1])==ARGV[1] then return redis.call('del',KEYS[1]) else return 0 end";
-        return eval(lua,key,getLockId()) > 0 && status == OK;
-    }
-
-    /**一个键（用于标识锁）和一个超时时间（默认为30秒）作为参数**/
-    bool lock(const string & key,int timeout=30){
-        /**将传入的超时时间转换为毫秒**/
-        int delay = timeout * 1000;
-        for (int i = 0; i < delay; i+=10) {
-            if (execute("set",key,getLockId(),"nx","ex",timeout) >= 0) return true;
-//            sleep(10);
-            Sleep(10);
-        }
-        return false;
-    }
-
-
-protected:
-    /** [捕获列表] (参数列表) -> 返回值类型 {
-            // 函数体
-        }
-     * Lambda 表达式的捕获列表用于指定在 Lambda 内部可以访问的外部变量。捕获列表的形式为 []，在括号内可以使用以下不同的方式来指定捕获变量：
-    不捕获任何变量：[]，表示 Lambda 不会访问任何外部变量。
-    捕获所有变量（按值捕获）：[=]，表示 Lambda 可以访问当前作用域内的所有变量，但是它们会被按值捕获，Lambda 内部对这些变量的修改不会影响外部。
-    捕获所有变量（按引用捕获）：[&]，表示 Lambda 可以访问当前作用域内的所有变量，它们会被按引用捕获，Lambda 内部对这些变量的修改会影响外部。
-    指定捕获的变量：[x, y]，表示只捕获 x 和 y 两个变量。
-    按值捕获指定变量：[=, &x]，表示按值捕获所有变量，但 x 会按引用捕获。
-    按引用捕获指定变量：[&, y]，表示按引用捕获所有变量，但 y 会按值捕获。
-    指定捕获变量并设置它们的捕获方式：[x, &y]，表示只捕获 x 和 y 两个变量，其中 x 按值捕获，y 按引用捕获。**/
-    virtual shared_ptr<RedisConnect> grasp() const{
-
-        /**静态初始化一个连接池ResPool<RedisConnect>  由后面的lambda函数初始化。
-         * 调用的构造函数是     ResPool(function<shared_ptr<T>()> func, int maxlen = 8, int timeout = 60)
-                            {
-                                this->timeout = timeout;
-                                this->maxlen = maxlen;
-                                this->func = func;  这个形参对应的实参是lambda函数
-                            }
-         * **/
-        static ResPool<RedisConnect> pool  ([&](){
-            /**创建了一个名为 redis 的智能指针，指向了一个新创建的 RedisConnect 对象，并使用 make_shared 函数进行初始化。
-             * make_shared 是 C++ 中用于创建智能指针的函数，它会动态分配内存来存储对象，并返回一个指向该对象的智能指针。**/
-           shared_ptr<RedisConnect> redis = make_shared<RedisConnect>();
-            if (redis && redis->connect(host,port,timeout,memsz)){
-                if (redis->auth(passwd)) return redis;
-            }
-            return redis = NULL;
-        },POOL_MAXLEN);
-
-        /**获取一个redis连接**/
-        shared_ptr<RedisConnect> redis = pool.get();
-
-        if (redis && redis->getErrorCode()){
-            pool.disable(redis);
-            /**失败就递归获取**/
-            return grasp();
-        }
-
-        return redis;
-    }
-
-public:
-    /**用于检查是否可以使用 Redis 连接库。它检查连接库的模板对象中的端口是否已配置。
-     * 如果端口大于0，表示可以使用连接库，返回true；否则返回false。**/
-    static bool CanUse(){
-        return GetTemplate()->port > 0;
-    }
-    /**返回一个RedisConnect对象的指针。是静态类型的RedisConnect 实例，用于保存配置信息和管理连接。**/
-    static RedisConnect * GetTemplate(){
-        static RedisConnect redis;
-        return &redis;
-    }
-
-    static shared_ptr<RedisConnect> Instance(){
-        /**单例模式
-         * 确保只有一个全局唯一的RedisConnect对象存在。这个RedisConnect提供连接所需要的配置
-         * 线程池里的连接共享这个配置，不必单独为每个连接设置连接属性。
-         *
-         * GetTemplete()Instance() 返回的是一个指向 RedisConnect 对象的 shared_ptr 智能指针，
-         * 这里GetTemplete()返回的是Setup中创建的那个单例RedisConnect ，这个RedisConnect指针调用grasp()**/
-        return GetTemplate()->grasp();
-    }
-    /**用于设置 Redis 连接库的配置信息。
-     * 并没有建立socket连接，建立连接是在Instance()实现的
-     * @return 先调用GetTemplete()获取一个RedisConnect对象，
-     * 它接受host主机名（或 IP 地址）、port端口号、密码、超时时间和内存大小作为参数，
-     * 并将这些配置信息存储在连接库的模板对象中。在 Linux 下，它还忽略了SIGPIPE信号，以避免因管道破裂而导致程序崩溃。**/
-    static void Setup(const string & host,int port,const string & passwd = "",int timeout = 3000,int memsz = 2 * 1024 * 1024){
-#ifdef LINUX
-        /**signal()处理信号函数，第一个参数是接受的信号，第二个参数是接收到对应信号要进行的操作，这里是忽略SIGPIPE信号
-         *以下情况会触发SIGPIPE信号
-         * 1）管道和FIFO（有名管道）操作：如果你在一个管道（包括匿名管道和有名管道）上写入数据，而没有进程在读取这些数据，这将导致 SIGPIPE 信号。
-
-           2）在已经关闭的文件描述符上写：如果你试图向一个已经关闭的文件描述符（包括文件、套接字、管道等）写数据，操作系统会检测到这一情况并向进程发送 SIGPIPE 信号。
-
-           3）使用内存映射的共享内存：在一些共享内存的情况下，如果你写入一个已经分离的共享内存区域，这也会触发 SIGPIPE 信号。
-         *
-         * 在这里本项目主要处理的是第二种情况，防止向已经关闭的socket连接输入数据时直接导致程序中断的情况，会忽略这个错误
-         * **/
-        signal(SIGPIPE,SIG_IGN);
-#else
-        WSADATA data; WSAStartup(MAKEWORD(2, 2), &data);
-#endif
-        RedisConnect * redis  = GetTemplate();
-        redis->host = host;
-        redis->port = port;
-        redis->memsz = memsz;
-        redis->passwd = passwd;
-        redis->timeout = timeout;
-    }
-};
-
-
-
-int RedisConnect::POOL_MAXLEN = 8;
-int RedisConnect::SOCKET_TIMEOUT = 10;
-#endif //REDISCONNECT_REDISCONNECT_MYSELF_H
-
-
-
-
-
+//
+// Created by LZH on 2023/6/28.
+//
+
+/**#ifndef REDISCONNECT_REDISCONNECT_MYSELF_H 是条件预处理指令，用于检查第一个名为 REDISCONNECT_REDISCONNECT_MYSELF_H
+ * 的宏是否被定义，如果没有被定义过，也就是第一次包含该头文件，那么下面直到#endif之间的代码将会被编译，且只编译一次
+ *
+ * #ifndef #endif以外的代码不受限制，可以被多次编译
+ **/
+#ifndef REDISCONNECT_REDISCONNECT_MYSELF_H
+#define REDISCONNECT_REDISCONNECT_MYSELF_H
+
+#include "RedisMetrics.h"
+#include "RedisCodec.h"
+#include "RedisCompress.h"
+#include "RedisScan.h"
+#include "RedisBreaker.h"
+
+#include <map>
+
+/**判断是否linux平台？**/
+#ifdef LINUX
+
+#include "errno.h"
+#include "netdb.h"
+#include "fcntl.h"
+#include "signal.h"
+#include "sys/time.h"
+#include "sys/wait.h"
+#include "sys/stat.h"
+#include "sys/file.h"
+#include "sys/types.h"
+#include "sys/ioctl.h"
+#include "arpa/inet.h"
+#include "sys/epoll.h"
+#include "sys/statfs.h"
+#include "sys/socket.h"
+#include "netinet/in.h"
+#include "sys/syscall.h"
+#include "sys/sendfile.h"
+#include "sys/un.h"
+#include "netinet/tcp.h"
+#include "poll.h"
+
+
+
+
+/**?**/
+#define ioctlsocket ioctl
+/**表示无效的socket**/
+#define INVALID_SOCKET (SOCKET)(-1)
+
+typedef int SOCKET;
+#endif
+
+/**编译期预先编码的命令名 "$3\r\nGET\r\n"，执行固定的命令时直接复制，不需要再计算长度和格式化。**/
+template<size_t N>
+struct RedisHeader
+{
+    char data[N + 8] = {};
+    int len = 0;
+
+    constexpr RedisHeader(const char (&name)[N]){
+        int sz = N - 1;
+        int num = 1;
+
+        data[len++] = '$';
+
+        while (num * 10 <= sz) num *= 10;
+
+        for (; num > 0; num /= 10) data[len++] = '0' + sz / num % 10;
+
+        data[len++] = '\r';
+        data[len++] = '\n';
+
+        for (int i = 0; i < sz; i++) data[len++] = name[i];
+
+        data[len++] = '\r';
+        data[len++] = '\n';
+    }
+};
+
+/**任意嵌套的响应节点，type 是 RESP 的类型字符（+ - : $ *），空值（$-1、*-1）的 type 为0**/
+struct RedisReply
+{
+    int type = 0;
+    int64 integer = 0;
+    string str;
+    vector<RedisReply> elements;
+
+    bool isNil() const{
+        return type == 0;
+    }
+    bool isArray() const{
+        return type == '*';
+    }
+};
+
+/**流中的一条消息**/
+struct RedisStreamEntry
+{
+    string id;
+    vector<pair<string,string>> fields;
+
+    /**从 [id, [field, value, ...]] 形式的响应节点中读取，节点中的字符串会被移走**/
+    bool load(RedisReply & node){
+        if (!node.isArray() || node.elements.size() < 2) return false;
+
+        RedisReply & list = node.elements[1];
+
+        id.swap(node.elements[0].str);
+        fields.clear();
+        fields.reserve(list.elements.size() / 2);
+
+        for (size_t i = 0; i + 1 < list.elements.size(); i += 2){
+            fields.emplace_back(std::move(list.elements[i].str),std::move(list.elements[i + 1].str));
+        }
+
+        return true;
+    }
+};
+
+/**成对的批量结果（HGETALL、ZRANGE WITHSCORES 等）。成员连续保存在 data 中，items 中的 string_view 指向 data，
+ * 值在读取时直接转换为 T（string_view 或数值），整个结果只需要分配几次内存。
+ * data 使用 vector 保存，移动后 string_view 仍然有效，但不能复制。**/
+template<class T>
+class RedisPairs
+{
+    friend class RedisConnect;
+
+protected:
+    vector<char> data;
+    vector<pair<string_view,T>> items;
+
+public:
+    RedisPairs(){
+    }
+    RedisPairs(RedisPairs &&) = default;
+    RedisPairs & operator = (RedisPairs &&) = default;
+    RedisPairs(const RedisPairs &) = delete;
+    RedisPairs & operator = (const RedisPairs &) = delete;
+
+    /**根据各个元素在 data 中的位置和长度生成结果，数值格式错误时返回 false**/
+    bool load(const vector<pair<int,int>> & offsets){
+        items.clear();
+        items.reserve(offsets.size() / 2);
+
+        for (size_t i = 0; i + 1 < offsets.size(); i += 2){
+            const pair<int,int> & key = offsets[i];
+            const pair<int,int> & val = offsets[i + 1];
+            const char * str = data.data() + val.first;
+            const char * end = str + max(val.second,0);
+
+            items.emplace_back(string_view(data.data() + key.first,max(key.second,0)),T());
+
+            if constexpr (is_same<T,string_view>::value){
+                items.back().second = string_view(str,end - str);
+            } else{
+                if (from_chars(str,end,items.back().second).ptr != end || str == end) return false;
+            }
+        }
+
+        return true;
+    }
+    void clear(){
+        data.clear();
+        items.clear();
+    }
+    bool empty() const{
+        return items.empty();
+    }
+    size_t size() const{
+        return items.size();
+    }
+    const pair<string_view,T> & operator [] (size_t idx) const{
+        return items[idx];
+    }
+    typename vector<pair<string_view,T>>::const_iterator begin() const{
+        return items.begin();
+    }
+    typename vector<pair<string_view,T>>::const_iterator end() const{
+        return items.end();
+    }
+};
+
+/**连接建立后设置的 socket 选项，通过 Setup 指定后连接池中的连接都使用同一组选项。
+ * 设置失败（系统不支持或者权限不足）时忽略，unix 域套接字只设置缓冲区大小。**/
+struct RedisSocketOption
+{
+    bool nodelay = true;    /**TCP_NODELAY，关闭 Nagle 算法，命令分多次写入时不会等待上一段数据的确认**/
+    bool keepalive = true;  /**SO_KEEPALIVE，空闲时定期探测，对端失效后连接能够及时断开，而不是等到下一条命令超时**/
+    int keepidle = 60;      /**空闲多少秒后开始探测**/
+    int keepintvl = 10;     /**探测的间隔（秒）**/
+    int keepcnt = 3;        /**连续多少次探测没有响应后断开连接**/
+    int sndbuf = 0;         /**SO_SNDBUF（字节），0 表示使用系统默认值**/
+    int rcvbuf = 0;         /**SO_RCVBUF（字节），0 表示使用系统默认值**/
+    int busypoll = 0;       /**SO_BUSY_POLL（微秒），读取时忙等网卡队列，降低延迟但占用 CPU，0 表示不启用**/
+    bool quickack = false;  /**TCP_QUICKACK，收到数据后立即确认。内核会自动关闭这个选项，所以每次读取后都要重新设置，多一次系统调用**/
+};
+
+class RedisConnect
+{
+    typedef std::mutex Mutex;
+    typedef std::lock_guard<std::mutex> Locker;
+
+    friend class Command;
+    friend class RedisHedge;
+
+public:
+    static const int OK = 1;      /**成功**/
+    static const int FAIL = -1;   /**失败**/
+    static const int IOERR = -2;  /**IO错误**/
+    static const int SYSERR = -3; /***系统错误**/
+    static const int NETERR = -4; /**网络错误？**/
+    static const int TIMEOUT = -5; /**超过时限**/
+    static const int DATAERR = -6;/**日期错误？**/
+    static const int SYSBUSY = -7;/**系统繁忙**/
+    static const int PARAMERR = -8; /**参数错误**/
+    static const int NOTFUND = -9;
+    static const int NETCLOSE = -10; /**网络关闭**/
+    static const int NETDELAY = -11; /**网络延迟**/
+    static const int AUTHFAIL = -12; /**认证失败**/
+
+public:
+    static int POOL_MAXLEN;
+    static int POOL_MINIDLE;         /**连接池最少空闲连接数，Setup 时预热**/
+    static int POOL_CHECK_INTERVAL;  /**后台检测空闲连接的间隔（毫秒），小于等于0表示不检测**/
+    static int POOL_MAX_LIFETIME;    /**连接的最长存活时间（毫秒），小于等于0表示不限制**/
+    static int POOL_MAX_IDLETIME;    /**连接的最长空闲时间（毫秒），小于等于0表示不限制**/
+    static int POOL_MAX_USES;        /**连接的最多使用次数，小于等于0表示不限制**/
+    static int POOL_THREAD_AFFINITY; /**线程亲和模式下最多独占连接的线程数，小于等于0表示不启用，最多 POOL_MAXLEN - 1**/
+    static bool METRICS_ENABLED;     /**是否按命令类型记录运行指标（RedisMetrics）**/
+    static int COMPRESS_TYPE;        /**set/hset 压缩值使用的算法（RedisCompress），NONE 表示不压缩**/
+    static int COMPRESS_LEVEL;       /**压缩级别，zstd 的压缩级别或 lz4 的加速因子，0 表示默认值**/
+    static int COMPRESS_THRESHOLD;   /**长度不小于这个值（字节）的值才压缩**/
+    static int SOCKET_TIMEOUT;
+    static int COMMAND_RETRY_TIMES;  /**幂等命令在连接断开时的最多重试次数，小于等于0表示不重试**/
+    static int BLOCK_RECV_TIMEOUT;   /**阻塞命令等待期间 socket 的接收超时（毫秒），越大空闲时唤醒越少**/
+    static int DNS_CACHE_TIME;       /**主机名解析结果的缓存时间（毫秒）**/
+    static int CONNECT_ATTEMPT_DELAY;/**有多个地址时，上一个地址多久（毫秒）没有连上就同时连接下一个地址**/
+    static int CONNECT_FAILURE_THRESHOLD; /**连续多少次建立连接失败后熔断（RedisBreaker），Setup 时生效**/
+    static int CONNECT_BACKOFF_MIN;  /**第一次熔断的时间（毫秒）**/
+    static int CONNECT_BACKOFF_MAX;  /**熔断时间的上限（毫秒），每次熔断翻倍，小于等于0表示不熔断**/
+
+public:
+    typedef RedisSocketOption SocketOption;
+
+public:
+    class Socket{
+    protected:
+        SOCKET sock = INVALID_SOCKET;
+        bool quickack = false;
+
+    public:
+        /**用于检查socket是否处于超时状态**/
+        static bool IsSocketTimeout(){
+#ifdef LINUX
+            /** ==0 表示没有错误
+             * EAGAIN 和 EWOULDBLOCK 在大多数情况下是等价的，表示操作被阻塞，但不是由于错误，可以稍后尝试
+             * EINTR 表示操作被信号中断。当进程收到信号时，正在进行的系统调用可能会被中断
+             * 以上表示当前操作无法完成或已被中断**/
+            return errno == 0 || errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#else
+            return WSAGetlastError() == WSAETIMEDOUT;
+#endif
+        }
+        /**SocketClose 函数接受一个套接字 sock 作为参数，并首先调用 IsSocketClosed 函数检查套接字是否已经关闭。
+         * 如果套接字已经关闭，函数直接返回，不做任何操作。否则，它会根据操作系统是 Linux 还是 Windows 执行相应的关闭操作**/
+        static void SocketClose(SOCKET sock){
+            if (IsSocketClosed(sock)) return;
+#ifdef LINUX
+            ::close(sock);
+#else
+            ::closesocket(sock);
+#endif
+        }
+        /**IsSocketClosed 函数接受一个套接字 sock 作为参数，用于检查套接字是否已关闭。**/
+        static bool IsSocketClosed(SOCKET sock){
+            return sock == INVALID_SOCKET || sock < 0;
+        }
+        /**设置套接字（SOCKET）的发送超时时间
+         * SOCKET sock：要设置超时的套接字。
+         * int timeout：超时时间，以毫秒为单位。**/
+        static bool SocketSetSendTimeout(SOCKET sock,int timeout){
+#ifdef LINUX
+            /**struct timeval 结构体，用于表示时间
+             * tv_sec 表示秒数部分，tv_usec 表示微秒部分。
+             * 将传入的 timeout 转换为秒和微秒，并设置到 tv 结构体中。
+             * **/
+            struct timeval tv;
+            tv.tv_sec = timeout / 1000;
+            tv.tv_usec = timeout % 1000 * 1000;
+            /**setsockopt 函数用于设置套接字（Socket）的选项，允许程序员控制套接字的行为。原型如下
+             * int setsockopt(int sockfd, int level, int optname, const void *optval, socklen_t optlen);
+                1）sockfd ：socket文件描述符，用于标识要设置选项的套接字。
+                2）level：选项所属的协议层或套接字类型，通常是 SOL_SOCKET 表示通用套接字选项，也可以是其他协议的特定选项。
+                         常见的协议层包括 SOL_SOCKET（通用套接字选项）、IPPROTO_TCP（TCP 协议选项）、IPPROTO_UDP（UDP 协议选项）等。
+                3）optname: 要设置的选项名称，表示需要修改的具体选项。例如，SO_REUSEADDR 表示允许地址重用，SO_RCVBUF 表示接收缓冲区大小等。
+                4) optval：指向包含选项值的缓冲区的指针。这个缓冲区通常包含一个特定类型的数据，用于设置选项的值。
+                5) optlen：optval 缓冲区的大小，以字节为单位。
+
+             * 将套接字的发送超时设置为 tv 结构体中指定的时间。这样，当调用套接字的发送操作，
+             * 如果发送操作在 timeout 毫秒内未能成功完成，就会返回一个超时错误。
+             * sock  要设置的socket
+             * SO_SNDTIMEO 是要设置的选项名称，它表示发送超时选项，用于设置发送数据时的超时限制。
+             * &tv 是一个指向 timeval 结构体的指针,表示要设置的时间
+             * sizeof 要设置的时间的大小**/
+            return setsockopt(sock,SOL_SOCKET,SO_SNDTIMEO,(char *)(&tv),sizeof(tv)) == 0;
+#else
+            return setsockopt(sock,SOL_SOCKET,SO_SNDTIMEO,(char *)(&timeout),sizeof(timeout)) == 0;
+#endif
+        }
+        /**和上面的差不多，上面是发送超时时间，这个是接收超时时间**/
+        static bool SocketSetRecvTimeout(SOCKET sock,int timeout){
+#ifdef LINUX
+            struct timeval tv;
+            tv.tv_sec = timeout / 1000;
+            tv.tv_usec = timeout % 1000 * 1000;
+
+            return setsockopt(sock,SOL_SOCKET,SO_RCVTIMEO,(char *)(&tv),sizeof(tv)) == 0;
+#else
+            return setsockopt(sock,SOL_SOCKET, SO_RCVTIMEO, (char*)(&timeout), sizeof(timeout)) == 0;
+#endif
+        }
+
+
+
+        /**解析后的一个连接地址**/
+        struct Address{
+            struct sockaddr_storage addr;
+            socklen_t len = 0;
+
+            int family() const{
+                return addr.ss_family;
+            }
+        };
+
+    protected:
+        struct ResolveCache{
+            mutex mtx;
+            map<string,pair<int64,vector<Address>>> items;  /**主机名对应的过期时间和地址，端口保存为0**/
+        };
+
+        static ResolveCache & GetResolveCache(){
+            static ResolveCache cache;
+
+            return cache;
+        }
+        static int64 Now(){
+            return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+        }
+        static void SetPort(Address & item,int port){
+            if (item.family() == AF_INET) ((struct sockaddr_in *)(&item.addr))->sin_port = htons(port);
+            if (item.family() == AF_INET6) ((struct sockaddr_in6 *)(&item.addr))->sin6_port = htons(port);
+        }
+        /**非阻塞的 connect 是否还在进行中**/
+        static bool IsConnectPending(){
+#ifdef LINUX
+            return errno == EINPROGRESS || errno == EAGAIN || errno == EINTR;
+#else
+            return WSAGetLastError() == WSAEWOULDBLOCK;
+#endif
+        }
+        /**按 happy eyeballs（RFC 8305）的顺序排列地址：两个地址族交替出现，解析结果中第一个地址的地址族优先**/
+        static void SortAddress(vector<Address> & vec){
+            if (vec.size() < 3) return;
+
+            vector<Address> first;
+            vector<Address> other;
+
+            for (const Address & item : vec) (item.family() == vec[0].family() ? first : other).push_back(item);
+
+            vec.clear();
+
+            for (size_t i = 0; i < first.size() || i < other.size(); i++){
+                if (i < first.size()) vec.push_back(first[i]);
+                if (i < other.size()) vec.push_back(other[i]);
+            }
+        }
+
+    public:
+        /**解析连接地址。"unix:/path" 表示 unix 域套接字（忽略 port），IPv6 地址可以写成 [::1]。
+         * 数字形式的地址直接转换，主机名用 getaddrinfo 解析，结果缓存 DNS_CACHE_TIME 毫秒，
+         * 缓存过期后解析失败时继续使用过期的结果。解析失败返回 false。**/
+        static bool Resolve(const string & host,int port,vector<Address> & vec){
+            Address item;
+
+            vec.clear();
+            memset(&item.addr,0,sizeof(item.addr));
+
+            if (host.compare(0,5,"unix:") == 0){
+#ifdef LINUX
+                struct sockaddr_un * addr = (struct sockaddr_un *)(&item.addr);
+                string path = host.substr(5);
+
+                if (path.empty() || path.length() >= sizeof(addr->sun_path)) return false;
+
+                addr->sun_family = AF_UNIX;
+                memcpy(addr->sun_path,path.c_str(),path.length() + 1);
+                item.len = offsetof(struct sockaddr_un,sun_path) + path.length() + 1;
+                vec.push_back(item);
+
+                return true;
+#else
+                return false;
+#endif
+            }
+
+            string name = host.length() > 2 && host.front() == '[' && host.back() == ']' ? host.substr(1,host.length() - 2) : host;
+            struct sockaddr_in * v4 = (struct sockaddr_in *)(&item.addr);
+            struct sockaddr_in6 * v6 = (struct sockaddr_in6 *)(&item.addr);
+
+            if (inet_pton(AF_INET,name.c_str(),&v4->sin_addr) == 1){
+                v4->sin_family = AF_INET;
+                item.len = sizeof(struct sockaddr_in);
+            } else if (inet_pton(AF_INET6,name.c_str(),&v6->sin6_addr) == 1){
+                v6->sin6_family = AF_INET6;
+                item.len = sizeof(struct sockaddr_in6);
+            }
+
+            if (item.len > 0){
+                SetPort(item,port);
+                vec.push_back(item);
+
+                return true;
+            }
+
+            int64 now = Now();
+            ResolveCache & cache = GetResolveCache();
+
+            {
+                lock_guard<mutex> lk(cache.mtx);
+
+                auto it = cache.items.find(name);
+
+                if (it != cache.items.end() && it->second.first > now) vec = it->second.second;
+            }
+
+            if (vec.empty()){
+                struct addrinfo hints;
+                struct addrinfo * list = NULL;
+
+                memset(&hints,0,sizeof(hints));
+                hints.ai_family = AF_UNSPEC;
+                hints.ai_socktype = SOCK_STREAM;
+                hints.ai_flags = AI_ADDRCONFIG;
+
+                if (getaddrinfo(name.c_str(),NULL,&hints,&list) == 0){
+                    for (struct addrinfo * ai = list; ai; ai = ai->ai_next){
+                        if ((ai->ai_family != AF_INET && ai->ai_family != AF_INET6) || ai->ai_addrlen > sizeof(item.addr)) continue;
+
+                        memset(&item.addr,0,sizeof(item.addr));
+                        memcpy(&item.addr,ai->ai_addr,ai->ai_addrlen);
+                        item.len = ai->ai_addrlen;
+                        vec.push_back(item);
+                    }
+
+                    freeaddrinfo(list);
+                }
+
+                lock_guard<mutex> lk(cache.mtx);
+
+                if (vec.size() > 0){
+                    SortAddress(vec);
+                    cache.items[name] = make_pair(now + DNS_CACHE_TIME,vec);
+                } else{
+                    auto it = cache.items.find(name);
+
+                    if (it != cache.items.end()) vec = it->second.second;
+                }
+            }
+
+            for (Address & addr : vec) SetPort(addr,port);
+
+            return vec.size() > 0;
+        }
+        /**发起非阻塞连接，连接立即完成时 done 为 true，失败时返回 INVALID_SOCKET**/
+        static SOCKET SocketStartConnect(const Address & addr,bool & done){
+            u_long mode = 1;
+            SOCKET sock = socket(addr.family(),SOCK_STREAM,0);
+
+            if (IsSocketClosed(sock)) return INVALID_SOCKET;
+
+            ioctlsocket(sock,FIONBIO,&mode);
+
+            if ((done = ::connect(sock,(const struct sockaddr *)(&addr.addr),addr.len) == 0) || IsConnectPending()) return sock;
+
+            SocketClose(sock);
+
+            return INVALID_SOCKET;
+        }
+        /**检查非阻塞连接的结果，成功时把套接字恢复为阻塞模式**/
+        static bool SocketFinishConnect(SOCKET sock){
+            int res = FAIL;
+            u_long mode = 0;
+            socklen_t len = sizeof(res);
+
+            if (getsockopt(sock,SOL_SOCKET,SO_ERROR,(char *)(&res),&len) < 0 || res != 0) return false;
+
+            ioctlsocket(sock,FIONBIO,&mode);
+
+            return true;
+        }
+        /**连接到 host 的 port 端口，host 的格式见 Resolve。
+         * 解析出多个地址时按 happy eyeballs 的方式连接：先连接第一个地址，CONNECT_ATTEMPT_DELAY 毫秒内没有连上
+         * 或者连接失败时再发起下一个，已经发起的连接继续等待，最先完成的连接胜出，其余的关闭。
+         * 成功时返回阻塞模式的套接字，失败或者超过 timeout 毫秒时返回 INVALID_SOCKET。**/
+        static SOCKET SocketConnectTimeout(const string & host,int port,int timeout){
+            vector<Address> addrs;
+
+            if (!Resolve(host,port,addrs)) return INVALID_SOCKET;
+
+            size_t next = 0;
+            vector<struct pollfd> fds;
+            SOCKET res = INVALID_SOCKET;
+            int64 now = Now();
+            int64 launch = now;
+            int64 deadline = now + timeout;
+
+            while (IsSocketClosed(res) && (now = Now()) < deadline){
+                if (next < addrs.size() && (now >= launch || fds.empty())){
+                    bool done = false;
+                    SOCKET sock = SocketStartConnect(addrs[next++],done);
+
+                    launch = now + CONNECT_ATTEMPT_DELAY;
+
+                    if (done){
+                        if (SocketFinishConnect(sock)) res = sock; else SocketClose(sock);
+                    } else if (!IsSocketClosed(sock)){
+                        struct pollfd item;
+
+                        item.fd = sock;
+                        item.events = POLLOUT;
+                        item.revents = 0;
+                        fds.push_back(item);
+                    }
+
+                    continue;
+                }
+
+                if (fds.empty()) break;
+
+                int64 wait = next < addrs.size() ? min(deadline,launch) - now : deadline - now;
+#ifdef LINUX
+                int num = poll(fds.data(),fds.size(),(int)(wait));
+#else
+                int num = WSAPoll(fds.data(),fds.size(),(int)(wait));
+#endif
+                for (size_t i = 0; i < fds.size() && num > 0;){
+                    if (fds[i].revents == 0){
+                        i++;
+                        continue;
+                    }
+
+                    num--;
+
+                    if (IsSocketClosed(res) && SocketFinishConnect(fds[i].fd)){
+                        res = fds[i].fd;
+                    } else{
+                        SocketClose(fds[i].fd);
+                        /**连接失败时立即发起下一个地址的连接**/
+                        launch = 0;
+                    }
+
+                    fds.erase(fds.begin() + i);
+                }
+            }
+
+            for (struct pollfd & item : fds) SocketClose(item.fd);
+
+            return res;
+        }
+        /**同时向 host 的 port 端口建立 count 个连接，所有连接在同一个 poll 中等待，总耗时约等于建立一个连接的时间。
+         * 每个连接按解析出的地址顺序尝试，失败时立即换下一个地址，超过 timeout 毫秒后放弃还没有完成的连接。
+         * 成功的套接字（阻塞模式）追加到 vec 中，返回成功的数量。**/
+        static int SocketConnectBatch(const string & host,int port,int timeout,int count,vector<SOCKET> & vec){
+            vector<Address> addrs;
+
+            if (count <= 0 || !Resolve(host,port,addrs)) return 0;
+
+            int cnt = 0;
+            vector<size_t> next;
+            vector<struct pollfd> fds;
+            int64 now = Now();
+            int64 deadline = now + timeout;
+
+            /**从第 idx 个地址开始发起连接，直到有一个地址可以连接或者地址用完**/
+            auto launch = [&](size_t idx){
+                while (idx < addrs.size()){
+                    bool done = false;
+                    SOCKET sock = SocketStartConnect(addrs[idx++],done);
+
+                    if (IsSocketClosed(sock)) continue;
+
+                    if (!done){
+                        struct pollfd item;
+
+                        item.fd = sock;
+                        item.events = POLLOUT;
+                        item.revents = 0;
+                        fds.push_back(item);
+                        next.push_back(idx);
+
+                        return;
+                    }
+
+                    if (SocketFinishConnect(sock)){
+                        vec.push_back(sock);
+                        cnt++;
+
+                        return;
+                    }
+
+                    SocketClose(sock);
+                }
+            };
+
+            for (int i = 0; i < count; i++) launch(0);
+
+            while (fds.size() > 0 && (now = Now()) < deadline){
+#ifdef LINUX
+                int num = poll(fds.data(),fds.size(),(int)(deadline - now));
+#else
+                int num = WSAPoll(fds.data(),fds.size(),(int)(deadline - now));
+#endif
+                for (size_t i = 0; i < fds.size() && num > 0;){
+                    if (fds[i].revents == 0){
+                        i++;
+                        continue;
+                    }
+
+                    num--;
+
+                    SOCKET sock = fds[i].fd;
+                    size_t idx = next[i];
+
+                    fds.erase(fds.begin() + i);
+                    next.erase(next.begin() + i);
+
+                    if (SocketFinishConnect(sock)){
+                        vec.push_back(sock);
+                        cnt++;
+                    } else{
+                        SocketClose(sock);
+                        /**新发起的连接追加在末尾，revents 为0，本轮不会处理**/
+                        launch(idx);
+                    }
+                }
+            }
+
+            for (struct pollfd & item : fds) SocketClose(item.fd);
+
+            return cnt;
+        }
+
+
+        /**设置 socket 选项，返回是否全部设置成功**/
+        static bool SocketSetOption(SOCKET sock,const SocketOption & option){
+            bool res = true;
+            struct sockaddr_storage addr;
+            socklen_t len = sizeof(addr);
+
+            auto set = [&](int level,int name,int val){
+                if (setsockopt(sock,level,name,(const char *)(&val),sizeof(val)) != 0) res = false;
+            };
+
+            if (option.sndbuf > 0) set(SOL_SOCKET,SO_SNDBUF,option.sndbuf);
+            if (option.rcvbuf > 0) set(SOL_SOCKET,SO_RCVBUF,option.rcvbuf);
+
+            memset(&addr,0,sizeof(addr));
+
+            if (getsockname(sock,(struct sockaddr *)(&addr),&len) != 0 || (addr.ss_family != AF_INET && addr.ss_family != AF_INET6)) return res;
+
+            set(IPPROTO_TCP,TCP_NODELAY,option.nodelay ? 1 : 0);
+            set(SOL_SOCKET,SO_KEEPALIVE,option.keepalive ? 1 : 0);
+
+            if (option.keepalive){
+#ifdef TCP_KEEPIDLE
+                if (option.keepidle > 0) set(IPPROTO_TCP,TCP_KEEPIDLE,option.keepidle);
+#endif
+#ifdef TCP_KEEPINTVL
+                if (option.keepintvl > 0) set(IPPROTO_TCP,TCP_KEEPINTVL,option.keepintvl);
+#endif
+#ifdef TCP_KEEPCNT
+                if (option.keepcnt > 0) set(IPPROTO_TCP,TCP_KEEPCNT,option.keepcnt);
+#endif
+            }
+#ifdef SO_BUSY_POLL
+            if (option.busypoll > 0) set(SOL_SOCKET,SO_BUSY_POLL,option.busypoll);
+#endif
+#ifdef TCP_QUICKACK
+            if (option.quickack) set(IPPROTO_TCP,TCP_QUICKACK,1);
+#endif
+            return res;
+        }
+
+    public:
+        /**关闭socket**/
+        void close(){
+            SocketClose(sock);
+            sock = INVALID_SOCKET;
+        }
+        /**const 的作用是确保函数不会修改类的内部状态，即不会修改 sock 这个成员变量的值。**/
+        bool isClosed() const{
+            return IsSocketClosed(sock);
+        }
+        /**设置发送超时时间**/
+        bool setSendTimeout(int timeout){
+            return SocketSetSendTimeout(sock,timeout);
+        }
+        /**设置接收超时**/
+        bool setRecvTimeout(int timeout){
+            return SocketSetRecvTimeout(sock,timeout);
+        }
+        /**设置 socket 选项**/
+        bool setOption(const SocketOption & option){
+            quickack = option.quickack;
+
+            return SocketSetOption(sock,option);
+        }
+        /**启用了 TCP_QUICKACK 时，每次读到数据后重新设置**/
+        void rearm(){
+#ifdef TCP_QUICKACK
+            if (quickack){
+                int val = 1;
+                setsockopt(sock,IPPROTO_TCP,TCP_QUICKACK,(const char *)(&val),sizeof(val));
+            }
+#endif
+        }
+
+        /**host 可以是 IP 地址（IPv4 或 IPv6）、主机名或者 "unix:/path"**/
+        bool connect(const std::string & host,int port,int timeout){
+            close();
+            sock = SocketConnectTimeout(host,port,timeout);
+            return IsSocketClosed(sock) ? false : true;
+        }
+        SOCKET getHandle() const{
+            return sock;
+        }
+        /**等待 socket 可读，timeout 毫秒内可读（或者出错、关闭）时返回 true**/
+        bool wait(int timeout){
+            struct pollfd item;
+
+            item.fd = sock;
+            item.events = POLLIN;
+            item.revents = 0;
+#ifdef LINUX
+            return poll(&item,1,timeout) > 0;
+#else
+            return WSAPoll(&item,1,timeout) > 0;
+#endif
+        }
+        /**接管一个已经建立的连接（SocketConnectBatch 的结果）**/
+        void attach(SOCKET sock){
+            close();
+            this->sock = sock;
+        }
+
+    public:
+        /**将data中的数据写入socket**/
+        int write(const void * data,int count){
+            const char * str = (const char *)(data);
+            int num = 0;    /**记录每次发送的字节数**/
+            int times = 0;  /**发送发送成功但一次发送字节数小于等于8的次数**/
+            int writed = 0; /**已成功发送的字节数**/
+
+            while (writed < count){
+                /**send() 函数是用于在socket上发送数据的函数。
+                 * ssize_t send(int sockfd, const void *buf, size_t len, int flags);
+                    sockfd：套接字文件描述符，指定要发送数据的套接字。
+                    buf：要发送的数据的缓冲区地址。
+                    len：要发送的数据的长度（以字节为单位）。
+                    flags：用于指定发送操作的标志，通常可以设置为0。
+
+                    send() 函数的返回值是已发送的字节数，如果出现错误则返回-1。
+                    send() 函数通常用于阻塞式套接字（默认情况下）。如果套接字是非阻塞的，它可以在没有足够数据发送时立即返回，
+                    并且返回值可能小于请求发送的数据长度。在非阻塞套接字上使用 send() 时需要谨慎处理返回值，因为需要检查返回值以确定实际发送了多少数据。
+                **/
+                /**将data中的数据写入到socket，每次从str+writed开始写**/
+                if ((num = send(sock,str+writed,count-writed,0)) > 0){
+                    if (num > 8){
+                        times = 0;
+                    } else{
+                        if (++times > 100) return TIMEOUT;
+                    }
+
+                    writed += num;
+                } else{
+                    if (IsSocketTimeout()){
+                        if (++times > 100) return TIMEOUT;
+                        continue;
+                    }
+                    return NETERR;
+                }
+            }
+
+            return writed;
+        }
+        /**从socket中读取数据，基本同上，有两种读取模式，completed和非completed**/
+        int read(void * data,int count,bool completed){
+            char * str = (char *)(data);
+            if (completed){
+                int num = 0;
+                int times = 0;
+                int readed = 0;
+
+                while (readed < count){
+                    /**recv() 是一个用于从套接字（Socket）接收数据的系统调用（函数）。它通常用于网络编程中，用于接收数据报文或消息。
+                     * int recv(int sockfd, void *buf, size_t len, int flags);
+                        sockfd：表示要接收数据的套接字文件描述符。
+                        buf：指向存储接收数据的缓冲区的指针。
+                        len：指定要接收的数据的最大长度。
+                        flags：指定接收数据的附加选项，通常可以设置为 0。
+                        返回值 如果 recv() 返回值大于 0，则表示成功接收了指定数量的字节数据。
+                              如果 recv() 返回值等于 0，表示对端（通常是远程服务器）已经关闭了连接。
+                              如果 recv() 返回值为 -1，表示发生了错误，此时可以使用 errno 全局变量获取错误码，以进一步确定错误的原因。
+
+                     **/
+                     /**将socket中的数据写入str+readed**/
+                    if ((num = recv(sock,str+ readed,count-readed,0)) > 0){
+                        if (num > 8){
+                            times = 0;
+                        } else{
+                            if (++times > 100){
+                                return TIMEOUT;
+                            }
+                        }
+                        readed += num;
+                    } else if (num==0){
+                        return NETCLOSE;
+                    } else{
+                        if (IsSocketTimeout()){
+                            if (++times > 100) return TIMEOUT;
+                            continue;
+                        }
+                        return NETERR;
+                    }
+                }
+                return readed;
+            } else{
+                int val = recv(sock,str,count,0);
+                if (val > 0){
+                    rearm();
+                    return val;
+                }
+                if (val == 0) return NETCLOSE;
+                if (IsSocketTimeout()) return 0;
+
+                return NETERR;
+            }
+        }
+#ifdef LINUX
+        /**用 sendfile 把文件 fd 中从 offset 开始的 count 个字节直接发送到socket，数据不经过用户态缓冲区。
+         * 返回发送的字节数，文件长度不足时返回 IOERR，超时和网络错误的处理与 write 相同。**/
+        int64 sendfile(int fd,int64 offset,int64 count){
+            int times = 0;
+            int64 sent = 0;
+            off_t pos = offset;
+
+            while (sent < count){
+                ssize_t num = ::sendfile(sock,fd,&pos,count - sent);
+
+                if (num > 0){
+                    times = 0;
+                    sent += num;
+                } else if (num == 0){
+                    return IOERR;
+                } else{
+                    if (IsSocketTimeout()){
+                        if (++times > 100) return TIMEOUT;
+                        continue;
+                    }
+                    return NETERR;
+                }
+            }
+
+            return sent;
+        }
+#endif
+    };
+
+    class Command {
+        friend RedisConnect;
+
+    protected:
+        int status;
+        int64 number = 0;  /**整数响应（:）的完整数值，status 中只保存截断到 int 范围的值**/
+        int bytes = 0;  /**解析完成的响应在缓冲区中占用的字节数，管道中用它定位下一条响应**/
+        int code = 0;   /**最近一次执行的结果，管道中用它区分每条命令的结果**/
+        RedisTrace * trace = NULL;  /**安装了 RedisTracer 时，执行期间记录各阶段的耗时**/
+        std::string msg;
+        std::string data;  /**编码后的命令，为空时由 vec 编码生成，修改参数后清空**/
+        vector<string> res;
+        vector<string> vec;
+        vector<char> * flat = NULL;                /**不为空时数组元素连续追加到 flat 中，不再逐个生成 string**/
+        vector<pair<int,int>> * offsets = NULL;    /**flat 模式下每个元素在 flat 中的位置和长度，空值的长度为-1**/
+        RedisReply * tree = NULL;                  /**不为空时按任意嵌套的结构解析响应，用于流等多层数组的响应**/
+
+    public:
+        /**命令参数的编码视图，字符串直接引用原数据，数值用 to_chars 转换到内部的缓冲区。
+         * 只作为临时对象使用，不能复制。**/
+        class Piece {
+        protected:
+            const char * ptr;
+            int len;
+            char buf[32];
+
+            template<class T>
+            static auto Cast(T val){
+                if constexpr (is_same<T,bool>::value){
+                    return (int)(val);
+                } else{
+                    return val;
+                }
+            }
+
+        public:
+            Piece(const string & val) : ptr(val.c_str()), len(val.length()){
+            }
+            Piece(const char * val) : ptr(val), len(strlen(val)){
+            }
+            template<class T,class = typename enable_if<is_arithmetic<T>::value>::type>
+            Piece(T val) : ptr(buf){
+                len = to_chars(buf,buf + sizeof(buf),Cast(val)).ptr - buf;
+            }
+            Piece(const Piece &) = delete;
+
+            const char * data() const{
+                return ptr;
+            }
+            size_t size() const{
+                return len;
+            }
+        };
+
+    protected:
+        static int Digits(size_t val){
+            int num = 1;
+
+            while (val >= 10){
+                val /= 10;
+                num++;
+            }
+
+            return num;
+        }
+        /**一次算出 RESP 编码后的总长度，分配一次内存后依次复制各个参数。
+         * head 是预先编码的命令名（可以为空），items 是其余的参数。**/
+        template<class ITEM>
+        static void Encode(string & dest,const char * head,int headlen,const ITEM * items,int count){
+            int argc = count + (headlen > 0 ? 1 : 0);
+            size_t len = 1 + Digits(argc) + 2 + headlen;
+
+            for (int i = 0; i < count; i++) len += 1 + Digits(items[i].size()) + 2 + items[i].size() + 2;
+
+            dest.resize(len);
+
+            char * str = &dest[0];
+            char * end = str + len;
+
+            *str++ = '*';
+            str = to_chars(str,end,argc).ptr;
+            *str++ = '\r';
+            *str++ = '\n';
+
+            if (headlen > 0){
+                memcpy(str,head,headlen);
+                str += headlen;
+            }
+
+            for (int i = 0; i < count; i++){
+                size_t sz = items[i].size();
+
+                *str++ = '$';
+                str = to_chars(str,end,sz).ptr;
+                *str++ = '\r';
+                *str++ = '\n';
+                memcpy(str,items[i].data(),sz);
+                str += sz;
+                *str++ = '\r';
+                *str++ = '\n';
+            }
+        }
+
+    protected:
+        /**nested 表示正在解析数组中嵌套的数组，这时不能清空外层数组已经解析出的元素**/
+        int parse(const char * msg,int len,bool nested = false){
+            number = 0;
+            /**嵌套结构的响应，数组返回元素个数，空值返回 NOTFUND**/
+            if (tree){
+                const char * str = msg;
+                int res = parseReply(str,msg + len,*tree);
+
+                if (res != OK) return res;
+
+                bytes = str - msg;
+
+                if (tree->type == '-'){
+                    this->msg = tree->str;
+                    return FAIL;
+                }
+
+                if (tree->isNil()) return NOTFUND;
+
+                return tree->isArray() ? tree->elements.size() : OK;
+            }
+            /**以 $ 开头，表示它是一个批定长度的字符串。它会调用 parseNode 函数来解析字符串，
+             * 并根据解析的结果返回相应的状态码（如 OK、TIMEOUT、NOTFUND）。
+             *
+             * get命令会返回  "$9\r\nlzh111111\r\n"**/
+            if (*msg == '$'){
+                const char * end = parseNode(msg,len);
+
+                if (end == NULL) return DATAERR;
+                if (end == msg) return TIMEOUT;
+
+                bytes = end - msg;
+                /**$-1 表示键不存在，parseNode 放入的空字符串占位需要去掉**/
+                if (msg[1] == '-'){
+                    if (flat){
+                        offsets->pop_back();
+                    } else{
+                        res.pop_back();
+                    }
+                    return NOTFUND;
+                }
+
+                return OK;
+            }
+            /**跳过resp协议规定的首字符如$ + - :*/
+            const char * str = msg + 1;
+            /**返回"\r\n"首次出现的位置**/
+            const char * end = RedisScan::FindCRLF(str,msg + len);
+            /**如果无法找到结束标记，返回原始的 msg，表示解析失败。**/
+            if (end == NULL) return TIMEOUT;
+            /**如果消息以 +、- 或 : 开头，表示它是一个状态回复，通常用于表示成功、失败或状态码。
+             * 根据消息的前缀字符，它设置相应的状态码和消息内容。**/
+            if (*msg == '+' || *msg == '-' || *msg == ':'){
+                this->bytes = end + 2 - msg;
+                this->status = OK;
+                /**截取除了首字符以及结尾的"\r\n"之间的字符串***/
+                this->msg = string(str,end);
+
+                if (*msg == '+') return OK;
+                if (*msg == '-') return FAIL;
+
+                from_chars(*str == '+' ? str + 1 : str,end,number);
+
+                this->status = (int)(max<int64>(numeric_limits<int>::min(),min<int64>(numeric_limits<int>::max(),number)));
+
+                return OK;
+            }
+
+
+            /**消息以 "*" 开头，表示这是一个多行回复，通常用于表示多个元素的数组。它解析数组的元素数量，然后循环处理每个元素。
+             * 每个元素都以 "$" 开头，后面跟着元素的长度。parseNode 被用来解析每个元素。解析完成后，它返回数组的长度。
+             * 一般数组元素中都是字符串，所以用parseNode解析数组内元素**/
+            if (*msg == '*'){
+                /**查看数组中有几个元素**/
+                int64 cnt = 0;
+
+                if (RedisScan::ParseInt(str,end + 2,cnt) != end) return DATAERR;
+                /**标记 RESP 响应字符串的末尾，以确保不超出字符串的长度。**/
+                const char * tail = msg +len;
+                /**移动到数组中第一个元素的位置**/
+                str = end + 2;
+                /**因为是数组，所以返回有多个，用res存储。数据不完整时会重新解析，需要先清空上一次解析的结果，
+                 * 嵌套的数组（如 SCAN 的游标之后的元素数组）追加在外层元素之后，只在最外层清空**/
+                if (!nested){
+                    res.clear();
+                    /**flat 模式下元素的总长度不会超过响应的长度，预先分配好内存**/
+                    if (flat){
+                        flat->clear();
+                        offsets->clear();
+                        flat->reserve(tail - str);
+                        offsets->reserve(min<int64>(max<int64>(cnt,0),(tail - str) / 4));
+                    }
+                }
+                /**遍历解析数组中元素**/
+                while (cnt > 0){
+                    /**如果这个元素还是数组，递归解析，元素追加在已经解析的元素之后，然后继续解析外层数组后面的元素**/
+                    if (*str == '*'){
+                        int val = parse(str,tail-str,true);
+                        if (val < 0) return val;
+
+                        str += bytes;
+                        cnt--;
+                        continue;
+                    }
+
+                    end = parseNode(str,tail- str);
+                    if (end == NULL) return DATAERR;
+                    if (end == str)  return TIMEOUT;
+
+                    str = end;
+                    cnt--;
+                }
+                bytes = str - msg;
+                return flat ? offsets->size() : res.size();
+            }
+            return DATAERR;
+        }
+        /**递归解析一个响应节点，解析成功后 str 指向下一个节点，数据不完整时返回 TIMEOUT**/
+        static int parseReply(const char * & str,const char * tail,RedisReply & node){
+            if (str >= tail) return TIMEOUT;
+
+            const char * end = RedisScan::FindCRLF(str,tail);
+
+            if (end == NULL) return TIMEOUT;
+            if (end - str < 1) return DATAERR;
+
+            end++;
+
+            int64 num = 0;
+            const char * line = str + 1;
+
+            node.type = *str;
+            node.integer = 0;
+            node.str.clear();
+            node.elements.clear();
+            str = end + 1;
+
+            switch (node.type){
+                case '+':
+                case '-':
+                    node.str.assign(line,end - 1);
+                    return OK;
+                case ':':
+                    from_chars(line,end - 1,node.integer);
+                    return OK;
+                case '$':
+                    from_chars(line,end - 1,num);
+
+                    if (num < 0){
+                        node.type = 0;
+                        return OK;
+                    }
+
+                    if (tail - str < num + 2) return TIMEOUT;
+
+                    node.str.assign(str,num);
+                    str += num + 2;
+                    return OK;
+                case '*':
+                    from_chars(line,end - 1,num);
+
+                    if (num < 0){
+                        node.type = 0;
+                        return OK;
+                    }
+                    /**每个元素至少占 3 个字节，元素个数超过剩余数据的长度时说明数据还不完整**/
+                    if (num > (tail - str) / 3 + 1) return TIMEOUT;
+
+                    node.elements.resize(num);
+
+                    for (RedisReply & item : node.elements){
+                        int res = parseReply(str,tail,item);
+                        if (res != OK) return res;
+                    }
+
+                    return OK;
+            }
+
+            return DATAERR;
+        }
+        /**用于解析 RESP 响应中的字符串节点。**/
+        const char * parseNode(const char * msg , int len){
+            /**跳过resp协议规定的首字符如$ + - :*/
+            const char * str = msg + 1;
+            const char * tail = msg + len;
+            /**数组中的整数或状态元素（如 :1），把这一行的内容作为元素**/
+            if (*msg != '$'){
+                const char * end = RedisScan::FindCRLF(str,tail);
+
+                if (end == NULL) return msg;
+
+                if (flat){
+                    offsets->emplace_back(flat->size(),end - str);
+                    flat->insert(flat->end(),str,end);
+                } else{
+                    res.emplace_back(str,end);
+                }
+
+                return end + 2;
+            }
+            /**解析字符串的长度，同时找到长度之后的"\r\n"，数据不完整时返回原始的 msg**/
+            int64 sz = 0;
+            const char * end = RedisScan::ParseInt(str,tail,sz);
+
+            if (end == NULL) return NULL;
+            if (end == tail) return msg;
+            /**sz 为负数时（$-1）表示空值，用空字符串占位，返回空值标记之后的位置。**/
+            if (sz < 0){
+                if (flat){
+                    offsets->emplace_back(flat->size(),-1);
+                } else{
+                    res.emplace_back();
+                }
+                return end + 2;
+            }
+            /*第一个元素起始位置***/
+            str = end + 2;
+            /**如果 RESP 响应的长度超出了给定的数据长度 len，返回原始的 msg，表示解析失败。**/
+            if (tail - str < sz + 2) return msg;
+            /**结束位置**/
+            end = str + sz + 2;
+            /**将成功解析的 RESP 字符串内容存入 res**/
+            if (flat){
+                offsets->emplace_back(flat->size(),sz);
+                flat->insert(flat->end(),str,str + sz);
+            } else{
+                res.emplace_back(string(str,str + sz));
+            }
+
+            return end;
+        }
+    public:
+        Command(){
+            this->status = 0;
+        }
+        Command(const string & cmd){
+            vec.emplace_back(cmd);
+            this->status = 0;
+        }
+        /**清空参数和结果，保留各个容器已经分配的内存，用于同一个对象反复执行不同的命令**/
+        void clear(){
+            status = 0;
+            number = 0;
+            bytes = 0;
+            trace = NULL;
+            flat = NULL;
+            offsets = NULL;
+            tree = NULL;
+            msg.clear();
+            data.clear();
+            res.clear();
+            vec.clear();
+        }
+        void add(const char * val){
+            data.clear();
+            vec.emplace_back(val);
+        }
+        void add(const string & val){
+            data.clear();
+            vec.emplace_back(val);
+        }
+
+        /**数值用 to_chars 转换，浮点数使用能精确还原的最短表示**/
+        template<class DATA_TYPE>
+        void add(DATA_TYPE val){
+            Piece item(val);
+
+            data.clear();
+            vec.emplace_back(item.data(),item.size());
+        }
+
+        /**递归调用 每次传入的参数中去掉了第一个参数 val**/
+        template<class DATA_TYPE,class ...ARGS>
+        void add(DATA_TYPE val,ARGS ...args){
+            add(val);
+            add(args...);
+        }
+
+    public:
+        /**toString 函数，用于将一组字符串转换为符合 Redis 协议的字符串表示形式。**/
+        string toString() const{
+            /**头部表示命令参数数量，例如，如果 vec 中有3个参数，头部将是 *3\r\n。
+             * 每个参数先是长度标识，例如长度是10时为 $10\r\n，然后是参数的内容和 \r\n。
+             * 先算出总长度再一次写入，不需要逐段扩容。**/
+            if (data.length() > 0) return data;
+
+            string msg;
+            Encode(msg,NULL,0,vec.data(),vec.size());
+            return msg;
+        }
+        /**编码后的命令，结果缓存在 data 中，同一条命令重复执行时不再编码**/
+        const string & encoded(){
+            if (data.empty()) Encode(data,NULL,0,vec.data(),vec.size());
+            return data;
+        }
+        /**直接把参数编码成一条命令，不生成 vec，之后不能再调用 add**/
+        template<class ...ARGS>
+        void encode(const ARGS & ...args){
+            Piece items[] = {Piece(args)...};
+
+            vec.clear();
+            Encode(data,NULL,0,items,sizeof...(args));
+        }
+        /**同上，命令名使用预先编码的头部**/
+        template<size_t N,class ...ARGS>
+        void encode(const RedisHeader<N> & head,const ARGS & ...args){
+            Piece items[sizeof...(args) + 1] = {Piece(args)...,Piece("")};
+
+            vec.clear();
+            Encode(data,head.data,head.len,items,sizeof...(args));
+        }
+        /**第 idx 个参数，idx 为0时是命令名。用 encode 生成的命令从编码后的数据中解析。**/
+        string getArg(int idx) const{
+            if (vec.size() > 0 || data.empty()) return idx < (int)(vec.size()) ? vec[idx] : string();
+
+            const char * str = data.c_str();
+            const char * end = str + data.length();
+
+            for (int i = -1; str < end; i++){
+                const char * tmp = (const char *)(memchr(str,'\n',end - str));
+
+                if (tmp == NULL) break;
+
+                int len = i < 0 ? 0 : atoi(str + 1);
+
+                str = tmp + 1;
+
+                if (i == idx) return string(str,min<int64>(len,end - str));
+                if (i >= 0) str += len + 2;
+            }
+
+            return string();
+        }
+
+        string get(int idx) const{
+            return res.at(idx);
+        }
+
+        const vector<string> & getDataList() const{
+            return res;
+        }
+
+        int64 getNumber() const{
+            return number;
+        }
+
+        /**读取并解析一条响应。
+         * readed 表示缓冲区中已有的数据长度（管道中上一条响应之后剩余的数据），
+         * 解析成功后把属于后续响应的数据移动到缓冲区开头，并通过 readed 返回剩余数据的长度。**/
+        int read(RedisConnect * redis,int timeout,int & readed){
+            int len = 0;           /**用于存储读取的数据长度**/
+            int delay = 0;         /**用于记录超时时间**/
+            char * dest = redis->buffer;  /**用于存储接收的数据**/
+            const int maxsz = redis->memsz;
+            Socket & sock = redis->sock;
+
+            int64 start = trace ? RedisTrace::Now() : 0;
+
+            auto analyse = [&](){
+                if (trace == NULL) return parse(dest,readed);
+
+                int64 now = RedisTrace::Now();
+                int res = parse(dest,readed);
+
+                trace->parse += RedisTrace::Now() - now;
+
+                return res;
+            };
+            auto done = [&](int res){
+                if (bytes > 0 && bytes <= readed){
+                    readed -= bytes;
+                    memmove(dest,dest + bytes,readed);
+                    dest[readed] = 0;
+                }
+                return res;
+            };
+
+            bytes = 0;
+
+            if (readed > 0){
+                dest[readed] = 0;
+                if ((len = analyse()) != TIMEOUT) return done(len);
+            }
+            /**确保没有读取超出指定最大长度的数据**/
+            while (readed < maxsz){
+                /**从连接中读取数据，并将读取的数据存储到 dest 缓冲区中，
+                 * dest中本身是可能有数据的，read后会覆盖dest到dest+len的数据，但是dest+len+1处可能还有字符，下面的dest[readed += len] = 0;就是在len+1处添加\0符号，终止**/
+                if ((len = sock.read(dest+readed,maxsz- readed, false)) < 0) return len;
+                /**表示暂时没有数据可读,增加 delay，若delay > timeout。说明超时，返回 TIMEOUT 表示响应超时**/
+                if (len == 0){
+                    delay +=  redis->waitstep;
+                    if (delay > timeout) return TIMEOUT;
+                } else{
+                    /**记录收到第一个字节的时间**/
+                    if (trace && readed == 0) trace->firstbyte = RedisTrace::Now() - start;
+                    /**终止符***/
+                    dest[readed += len] = 0;
+                    /**将读取到的数据传递给 parse 函数来解析响应数据,将数据存入res中。如果 parse 函数返回 TIMEOUT，表示需要继续等待更多数据。**/
+                    if ((len = analyse()) == TIMEOUT){
+                        delay = 0;
+                    } else{
+                        return done(len);
+                    }
+                }
+            }
+            return PARAMERR;
+        }
+        /**记录执行结果，code 小于 0 且没有错误信息时填充默认的错误信息，并同步到 redis 的 code、status、msg**/
+        int finish(RedisConnect * redis,int code){
+            redis->code = this->code = code;
+            /**redis->code 小于 0说明出问题了  若执行成功，cmd.msg不会为空，会在dowork中的parse里设置**/
+            if (redis->code < 0 && msg.empty()){
+                switch (redis->code) {
+                    case IOERR:
+                        msg = "io error";
+                        break;
+                    case SYSERR:
+                        msg = "system error";
+                        break;
+                    case NETERR:
+                        msg = "network error";
+                        break;
+                    case DATAERR:
+                        msg = "protocol error";
+                        break;
+                    case TIMEOUT:
+                        msg = "response timeout";
+                        break;
+                    case NOTFUND:
+                        msg = "element not found";
+                        break;
+                    default:
+                        msg = "unknown error";
+                }
+            }
+
+            redis->status = status;
+            redis->number = number;
+            redis->msg = msg;
+
+            return redis->code;
+        }
+
+        /**记录命令的运行指标，start 是开始写入命令的时间**/
+        void record(chrono::steady_clock::time_point start,int sendsz,int code) const{
+            int64 usec = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+
+            RedisMetrics::Record(getArg(0),usec,sendsz,code < 0 ? 0 : bytes,code < 0 && code != NOTFUND);
+        }
+        /**补全跟踪信息，由 tracer 判断是否上报。命令名和键只在需要上报时才复制。**/
+        void report(RedisTracer * tracer,RedisConnect * redis,int64 start,int sendsz,int code){
+            RedisTrace & item = *trace;
+
+            trace = NULL;
+
+            item.code = code;
+            item.sendsz = sendsz;
+            item.recvsz = code < 0 ? 0 : bytes;
+            item.total = RedisTrace::Now() - start;
+            item.poolwait = redis->poolwait;
+
+            redis->poolwait = 0;
+
+            if (!tracer->accept(item)) return;
+
+            item.command = getArg(0);
+            item.key = getArg(1);
+
+            tracer->trace(item);
+        }
+
+        /**执行命令，幂等的命令（IsIdempotent）在连接断开（NETERR、NETCLOSE）时重新建立连接后重试，
+         * 最多重试 COMMAND_RETRY_TIMES 次，所有重试都在原来的 timeout 之内完成，其他命令的失败直接返回给调用者。
+         * 服务端按空闲时间关闭连接后，空闲一段时间后的第一条命令不会再偶发失败。**/
+        int getResult(RedisConnect * redis,int timeout){
+            int64 deadline = COMMAND_RETRY_TIMES > 0 ? RedisBreaker::Now() + timeout : 0;
+            int code = request(redis,timeout);
+
+            for (int i = 0; i < COMMAND_RETRY_TIMES && (code == NETERR || code == NETCLOSE); i++){
+                int remain = (int)(deadline - RedisBreaker::Now());
+
+                if (remain <= 0 || !IsIdempotent(getArg(0)) || !redis->reopen(remain)) break;
+                /**丢弃上一次不完整的结果**/
+                res.clear();
+
+                if (flat) flat->clear();
+                if (offsets) offsets->clear();
+
+                code = request(redis,remain);
+            }
+
+            return code;
+        }
+
+    protected:
+        /**写入命令并读取一条响应，记录运行指标和跟踪信息**/
+        int request(RedisConnect * redis,int timeout){
+            int sendsz = 0;
+            RedisTracer * tracer = RedisTracer::Get();
+            /**lambda函数，执行redis命令**/
+            auto doWork = [&](){
+                /**toString获取redis命令
+                 * get命令    "*2\r\n$3\r\nget\r\n$5\r\nname2\r\n"
+                 * set命令   ""*3\r\n$3\r\nset\r\n$4\r\nname\r\n$9\r\nlzh111111\r\n""
+                 * 删除锁的命令 "*5\r\n$4\r\neval\r\n$93\r\nif redis.call('get',KEYS[1])==ARGV[1] then return redis.call('del',KEYS[1]) else return 0 end\r\n$1\r\n1\r\n$6\r\nlockey\r\n$26\r\n172.20.123.254:51235:51235\r\n"**/
+                const string & msg = encoded();
+                sendsz = msg.length();
+                /**获取socket连接**/
+                Socket & sock = redis->sock;
+                int64 now = trace ? RedisTrace::Now() : 0;
+                /**将命令字符串 msg 写入到与 Redis 服务器的socket连接中，如果写入失败（返回值小于 0），则返回 NETERR，表示网络错误。**/
+                if (sock.write(msg.c_str(),msg.length()) < 0) return NETERR;
+
+                if (trace) trace->write = RedisTrace::Now() - now;
+
+                int readed = 0;
+
+                return read(redis,timeout,readed);
+            };
+            /**重置cmd的status和msg**/
+            status = 0;
+            msg.clear();
+
+            if ((!METRICS_ENABLED && tracer == NULL) || redis->background) return finish(redis,doWork());
+
+            RedisTrace item;
+            int64 now = tracer ? RedisTrace::Now() : 0;
+            auto start = chrono::steady_clock::now();
+
+            if (tracer) trace = &item;
+
+            int code = finish(redis,doWork());
+
+            if (METRICS_ENABLED) record(start,sendsz,code);
+            if (tracer) report(tracer,redis,now,sendsz,code);
+
+            trace = NULL;
+
+            return code;
+        }
+};
+
+protected:
+    /**code 通常用来表示具体的执行结果或错误码。在 RedisConnect 类中，code 变量用于存储执行命令或操作的返回状态码，
+     * 例如成功执行时可能是 0，不同的错误情况可能对应不同的非零状态码。这个状态码可以帮助开发人员判断具体执行过程中是否出现了问题。**/
+    int code = 0;   /**错误代码**/
+    int port = 0;   /**redis服务器端口号**/
+    int memsz = 0;  /**缓存数据的内存大小**/
+    /**status 变量通常用于表示一个更宽泛的状态或标志，它可能不是具体的数字错误码。在 RedisConnect 类中，status
+     * 变量可能表示连接状态或操作状态的标志，比如是否成功连接到 Redis 服务器、是否成功获取分布式锁等。这个状态通常是布尔值或枚举类型，
+     * 更容易理解操作的成功与否。**/
+    int status = 0; /**连接状态**/
+    int timeout = 0;/**超时时间**/
+    SocketOption option;  /**连接使用的 socket 选项**/
+    RedisBreaker * breaker = NULL; /**Setup 的地址对应的熔断器，只在模板对象中设置**/
+    int waitstep = SOCKET_TIMEOUT; /**socket 当前的接收超时（毫秒），每次读不到数据时按它累计等待时间**/
+    int64 number = 0;   /**最近一次整数响应的完整数值，超出 int 范围时 status 会被截断**/
+    int64 poolwait = 0; /**安装了 RedisTracer 时，记录 Instance() 获取这个连接的耗时（微秒）**/
+    bool background = false; /**正在执行后台的健康检测，命令不计入运行指标，也不上报给跟踪接口**/
+    char * buffer = NULL; /**数据缓冲区**/
+    vector<char> arena;                 /**string_view 形式的结果使用的内存块，每条命令执行前清空，容量在命令之间保留**/
+    vector<pair<int,int>> arenaoffsets; /**arena 中每个元素的位置和长度**/
+    vector<vector<char>> pipearenas;                 /**管道中每条命令的 arena，用于 execute(vector<string_view> &,vector<Command> &)**/
+    vector<vector<pair<int,int>>> pipearenaoffsets;  /**pipearenas 中每个元素的位置和长度**/
+    Command context;                    /**execute 系列函数复用的命令对象，参数和结果的内存在命令之间保留**/
+    vector<string_view> views;          /**get、hget、lpop 等读取单个值时复用的结果列表**/
+
+    string msg;      /**错误信息**/
+    string host;     /**服务器主机**/
+    Socket sock;     /**socket**/
+    string passwd;   /**密码**/
+
+public:
+    ~RedisConnect(){
+        close();
+    }
+
+public:
+    /**获取连接状态**/
+    int getStatus() const{
+        return status;
+    }
+    /**获取最近一次整数响应的 64 位数值**/
+    int64 getNumber() const{
+        return number;
+    }
+//    获取错误代码。
+    int getErrorCode() const{
+        if (sock.isClosed()) return FAIL;
+        return code < 0 ? code : 0;
+    }
+//    获取错误消息。
+    string getErrorString() const{
+        return msg;
+    }
+    /**连接是否已经不可用：socket 已关闭，或者上一条命令出现了网络/协议错误（响应可能还残留在 socket 中）。
+     * 服务端返回的错误（FAIL）和键不存在（NOTFUND）不影响连接继续使用。**/
+    bool isBroken() const{
+        if (sock.isClosed()) return true;
+        return code < 0 && code != FAIL && code != NOTFUND;
+    }
+
+public:
+    /**关闭连接并释放资源。
+    该方法用于关闭与 Redis 服务器的socket，同时释放内存资源。如果之前分配了缓冲区，也会释放缓冲区。**/
+    void close(){
+        if (buffer){
+            delete[] buffer;
+            buffer = NULL;
+        }
+        vector<char>().swap(arena);
+        vector<pair<int,int>>().swap(arenaoffsets);
+        vector<vector<char>>().swap(pipearenas);
+        vector<vector<pair<int,int>>>().swap(pipearenaoffsets);
+        sock.close();
+    }
+    /**重新连接到 Redis 服务器。
+     * 如果成功重新连接并进行身份验证（如果设置了密码），则返回true；否则，返回false。**/
+    bool reconnect(){
+        if (host.empty()) return false;
+
+        return connect(host,port,timeout,memsz,option) && auth(passwd) > 0;
+    }
+protected:
+    /**重试命令前在原来的地址上重新建立连接，timeout 是剩余的时间（毫秒），连接的超时配置保持不变。
+     * 认证使用单独的命令对象，不影响正在重试的命令。连接的是 Setup 的地址时同样受熔断器限制。**/
+    bool reopen(int timeout){
+        RedisConnect * tmpl = GetTemplate();
+        RedisBreaker * breaker = tmpl->breaker && tmpl->host == host && tmpl->port == port ? tmpl->breaker : NULL;
+
+        if (host.empty() || (breaker && !breaker->acquire())) return false;
+
+        int limit = this->timeout;
+        bool connected = connect(host,port,min(timeout,limit),memsz,option);
+
+        if (breaker) breaker->release(connected);
+
+        if (!connected) return false;
+
+        this->timeout = limit;
+
+        if (passwd.empty()) return true;
+
+        Command cmd;
+
+        cmd.encode("auth",passwd);
+
+        return cmd.getResult(this,timeout) > 0;
+    }
+
+    /**只写入命令不读取响应，与 receive 配合使用，可以在等待响应的同时做其他事情（例如对冲请求）**/
+    int submit(Command & cmd){
+        cmd.status = 0;
+        cmd.msg.clear();
+
+        const string & msg = cmd.encoded();
+
+        return code = sock.write(msg.c_str(),msg.length()) < 0 ? NETERR : OK;
+    }
+    /**读取 submit 写入的命令的响应**/
+    int receive(Command & cmd,int timeout){
+        int readed = 0;
+
+        return cmd.finish(this,cmd.read(this,timeout,readed));
+    }
+    /**同上，用于 GET、HGET 这类返回单个值的命令，值解压后保存在 val 中**/
+    int receive(Command & cmd,int timeout,string & val){
+        if (receive(cmd,timeout) < 0) return code;
+        if (cmd.res.empty()) return code = DATAERR;
+
+        return uncompress(cmd.res[0],val);
+    }
+
+public:
+    /**执行 Redis 命令并返回执行结果。**/
+    int execute(Command & cmd){
+        return cmd.getResult(this,timeout);
+    }
+    /**管道：把多条命令合并成一次写入，再依次读取每条命令的响应，减少网络往返次数。
+     * 每条命令的结果保存在各自的 Command 中，返回最后一条命令的执行结果；
+     * 中途出现网络错误时，后续命令的结果都记为该错误。**/
+    int execute(vector<Command> & cmds){
+        string msg;
+        int res = OK;
+        int readed = 0;
+        vector<int> sizes;
+        vector<RedisTrace> items;
+        RedisTracer * tracer = RedisTracer::Get();
+        int64 now = tracer ? RedisTrace::Now() : 0;
+        auto start = chrono::steady_clock::now();
+
+        for (Command & cmd : cmds){
+            int len = msg.length();
+            msg += cmd.encoded();
+            sizes.push_back(msg.length() - len);
+            cmd.status = 0;
+            cmd.msg.clear();
+            cmd.res.clear();
+        }
+
+        if (cmds.empty()) return res;
+
+        if (sock.write(msg.c_str(),msg.length()) < 0) res = NETERR;
+
+        if (tracer) items.resize(cmds.size());
+        /**整批命令一次写入，每条命令的 write 都是整批写入的耗时**/
+        for (RedisTrace & item : items) item.write = RedisTrace::Now() - now;
+
+        for (size_t i = 0; i < cmds.size(); i++){
+            Command & cmd = cmds[i];
+
+            if (tracer) cmd.trace = &items[i];
+            /**服务端返回的错误（FAIL）和键不存在（NOTFUND）不影响读取后续响应**/
+            if (res >= 0 || res == FAIL || res == NOTFUND){
+                res = cmd.finish(this,cmd.read(this,timeout,readed));
+            } else{
+                cmd.bytes = 0;
+                cmd.finish(this,res);
+            }
+            /**管道中每条命令的延迟是从写入整批命令到读取到该命令响应的时间**/
+            if (METRICS_ENABLED) cmd.record(start,sizes[i],code);
+            if (tracer) cmd.report(tracer,this,now,sizes[i],code);
+        }
+
+        return res;
+    }
+    /**管道，用于 MGET、HMGET 这类返回数组的命令和 GET 这类返回单个值的命令：所有命令的结果按顺序追加到 vec 中，
+     * 空值元素和不存在的单个值（NOTFUND）的 data() 为 NULL。
+     * 每条命令的元素保存在连接自带的内存块中（同 execute(vector<string_view> &...)），结果在这个连接执行下一条命令或者关闭之前有效。
+     * 返回值同 execute(vector<Command> &)，有命令失败时 vec 中缺少它的元素，调用者可以按元素个数检查。**/
+    int execute(vector<string_view> & vec,vector<Command> & cmds){
+        vec.clear();
+
+        if (pipearenas.size() < cmds.size()){
+            pipearenas.resize(cmds.size());
+            pipearenaoffsets.resize(cmds.size());
+        }
+
+        for (size_t i = 0; i < cmds.size(); i++){
+            pipearenas[i].clear();
+            pipearenaoffsets[i].clear();
+            cmds[i].flat = &pipearenas[i];
+            cmds[i].offsets = &pipearenaoffsets[i];
+        }
+
+        int res = execute(cmds);
+
+        for (size_t i = 0; i < cmds.size(); i++){
+            const vector<char> & data = pipearenas[i];
+            /**单个值不存在时（$-1）没有元素，用空值占位**/
+            if (cmds[i].code == NOTFUND && pipearenaoffsets[i].empty()) vec.emplace_back();
+
+            for (const pair<int,int> & item : pipearenaoffsets[i]){
+                vec.emplace_back(item.second < 0 ? string_view() : string_view(data.data() + item.first,item.second));
+            }
+
+            cmds[i].flat = NULL;
+            cmds[i].offsets = NULL;
+        }
+
+        return res;
+    }
+    /**同上
+     * val：表示要执行的 Redis 命令的参数。
+        args...：可选的额外参数。
+
+        ...args 表示将参数包 args 展开成单独的参数。
+        args... 表示将多个参数打包成一个参数包。**/
+    template<class DATA_TYPE,class ...ARGS>
+    int execute(const DATA_TYPE & val,const ARGS & ...args){
+        /**初始化一个Command对象**/
+        Command & cmd = prepare();
+        /**将参数直接编码成一条命令 "*3\r\n$3\r\nset\r\n$4\r\nname\r\n$9\r\nlzh111111\r\n"**/
+        cmd.encode(val,args...);
+
+        return cmd.getResult(this,timeout);
+    }
+    /**同上上
+     * vec：一个字符串向量，用于存储命令的执行结果。
+        val：表示要执行的 Redis 命令的参数。
+        args...：可选的额外参数。**/
+    template<class DATA_TYPE, class ...ARGS>
+    int execute(vector<string>& vec, const DATA_TYPE& val, const ARGS& ...args)
+    {
+        Command & cmd = prepare();
+
+        cmd.encode(val, args...);
+
+        cmd.getResult(this, timeout);
+
+        if (code > 0) std::swap(vec, cmd.res);
+
+        return code;
+    }
+    /**同上，结果的元素不再逐个生成 string，而是连续保存在连接自带的内存块中，vec 中的 string_view 指向这块内存。
+     * 结果在这个连接执行下一条命令或者关闭之前有效，空值元素的 data() 为 NULL。
+     * 内存块只在命令之间清空不释放，大小不会超过接收缓冲区，反复读取大数组时不再有逐个元素的内存分配。**/
+    template<class DATA_TYPE,class ...ARGS>
+    int execute(vector<string_view> & vec,const DATA_TYPE & val,const ARGS & ...args){
+        Command & cmd = prepare();
+
+        cmd.encode(val,args...);
+
+        return executeView(vec,cmd);
+    }
+
+public:
+    /**常用命令预先编码好的命令名**/
+    struct Header
+    {
+        static constexpr RedisHeader GET{"GET"};
+        static constexpr RedisHeader SET{"SET"};
+        static constexpr RedisHeader DEL{"DEL"};
+        static constexpr RedisHeader TTL{"TTL"};
+        static constexpr RedisHeader HGET{"HGET"};
+        static constexpr RedisHeader HSET{"HSET"};
+        static constexpr RedisHeader HDEL{"HDEL"};
+        static constexpr RedisHeader HLEN{"HLEN"};
+        static constexpr RedisHeader SETEX{"SETEX"};
+        static constexpr RedisHeader INCRBY{"INCRBY"};
+        static constexpr RedisHeader DECRBY{"DECRBY"};
+        static constexpr RedisHeader EXPIRE{"EXPIRE"};
+    };
+
+    /**命令是否是幂等的（只读），连接断开时只有这些命令会自动重试。
+     * INCR、LPUSH 这类写命令可能已经在服务端执行过，重试会重复执行，所以不在其中。**/
+    static bool IsIdempotent(const string & cmd){
+        static const char * names[] = {
+            "GET", "MGET", "STRLEN", "GETRANGE", "EXISTS", "TTL", "PTTL", "TYPE",
+            "HGET", "HMGET", "HGETALL", "HEXISTS", "HLEN", "HKEYS", "HVALS", "HSTRLEN",
+            "LRANGE", "LLEN", "LINDEX", "SCARD", "SISMEMBER", "SMISMEMBER", "SMEMBERS",
+            "ZRANGE", "ZRANGEBYSCORE", "ZREVRANGE", "ZREVRANGEBYSCORE", "ZSCORE", "ZMSCORE", "ZCARD", "ZCOUNT", "ZRANK", "ZREVRANK",
+            "XRANGE", "XREVRANGE", "XLEN", "SCAN", "HSCAN", "SSCAN", "ZSCAN", "PING", "ECHO", "DBSIZE"
+        };
+
+        for (const char * name : names){
+            if (strcasecmp(name,cmd.c_str()) == 0) return true;
+        }
+
+        return false;
+    }
+
+    /**同上，命令名使用预先编码的头部，例如 execute(Header::GET, key)**/
+    template<size_t N,class ...ARGS>
+    int execute(const RedisHeader<N> & head,const ARGS & ...args){
+        Command & cmd = prepare();
+        cmd.encode(head,args...);
+        return cmd.getResult(this,timeout);
+    }
+    template<size_t N,class ...ARGS>
+    int execute(vector<string> & vec,const RedisHeader<N> & head,const ARGS & ...args){
+        Command & cmd = prepare();
+
+        cmd.encode(head,args...);
+        cmd.getResult(this,timeout);
+
+        if (code > 0) std::swap(vec,cmd.res);
+
+        return code;
+    }
+    template<size_t N,class ...ARGS>
+    int execute(vector<string_view> & vec,const RedisHeader<N> & head,const ARGS & ...args){
+        Command & cmd = prepare();
+
+        cmd.encode(head,args...);
+
+        return executeView(vec,cmd);
+    }
+
+protected:
+    /**清空并返回连接复用的命令对象。一个连接同一时间只执行一条命令，
+     * 调用者需要在执行下一条命令之前取走结果（swap 或复制），不能在持有它的结果时再调用其他 execute。**/
+    Command & prepare(){
+        context.clear();
+        return context;
+    }
+    int executeView(vector<string_view> & vec,Command & cmd){
+        arena.clear();
+        arenaoffsets.clear();
+        vec.clear();
+
+        cmd.flat = &arena;
+        cmd.offsets = &arenaoffsets;
+
+        if (cmd.getResult(this,timeout) <= 0) return code;
+
+        vec.reserve(arenaoffsets.size());
+
+        for (const pair<int,int> & item : arenaoffsets){
+            vec.emplace_back(item.second < 0 ? string_view() : string_view(arena.data() + item.first,item.second));
+        }
+
+        return code;
+    }
+
+public:
+    /**用于连接到指定的主机和端口，并进行一些初始化操作。**/
+    bool connect(const string & host,int port,int timeout = 3000,int memsz = 2 * 1024 * 1024,const SocketOption & option = SocketOption()){
+        /**首先调用 close() 函数来关闭可能已经存在的连接。**/
+        close();
+        /**如果连接成功，进行后续操作**/
+        if (sock.connect(host,port,timeout)) init(host,port,timeout,memsz,option);
+        /**若缓冲区申请成功，说明连接成功**/
+        return buffer ? true: false;
+    }
+
+protected:
+    /**连接建立后的初始化：设置超时和 socket 选项，保存连接参数并分配接收缓冲区**/
+    void init(const string & host,int port,int timeout,int memsz,const SocketOption & option){
+        /**设置发送/接收超时时间和 socket 选项**/
+        sock.setSendTimeout(SOCKET_TIMEOUT);
+        sock.setRecvTimeout(waitstep = SOCKET_TIMEOUT);
+        sock.setOption(option);
+        this->option = option;
+        /**设置host，port,缓冲区大小，超时时间，缓冲区**/
+        this->host = host;
+        this->port = port;
+        this->memsz = memsz;
+        this->timeout = timeout;
+        this->buffer = new char [memsz + 1];
+    }
+
+public:
+    int ping(){
+        return execute("ping");
+    }
+    /**健康检测：PING 成功返回 true。用于连接池的后台检测，不计入 PING 的运行指标和跟踪信息，避免后台流量混入业务命令的统计**/
+    bool probe(){
+        background = true;
+
+        bool res = ping() > 0 && getErrorCode() == 0;
+
+        background = false;
+
+        return res;
+    }
+
+    int del(const string & key){
+        return execute(Header::DEL,key);
+    }
+
+    int ttl(const string & key){
+        return execute(Header::TTL,key) == OK ? status : code;
+    }
+
+    int hlen(const string & key){
+        return execute(Header::HLEN,key) == OK ? status : code;
+    }
+    /**密码登录**/
+    int auth(const string & passwd){
+        this->passwd = passwd;
+        /**空密码就说明没有密码，登录成功**/
+        if (passwd.empty()) return OK;
+        return execute("auth",passwd);
+    }
+
+    int get(const string & key,string & val){
+        if (execute(views,Header::GET,key) < 0) return code;
+        return uncompress(views[0],val);
+    }
+
+    int decr(const string& key, int64 val = 1)
+    {
+        return execute(Header::DECRBY, key, val);
+    }
+
+    int incr(const string& key, int64 val = 1)
+    {
+        return execute(Header::INCRBY, key, val);
+    }
+    /**整数自增，res 返回自增后的值**/
+    int incrby(const string& key, int64 val, int64& res)
+    {
+        if (execute(Header::INCRBY, key, val) > 0) res = number;
+
+        return code;
+    }
+    /**整数自减，res 返回自减后的值**/
+    int decrby(const string& key, int64 val, int64& res)
+    {
+        if (execute(Header::DECRBY, key, val) > 0) res = number;
+
+        return code;
+    }
+    /**浮点数自增，res 返回自增后的值，响应的格式错误时返回 DATAERR**/
+    int incrbyfloat(const string& key, double val, double& res)
+    {
+        vector<string> vec;
+
+        if (execute(vec, "incrbyfloat", key, val) <= 0) return code;
+
+        return parseNumber(vec[0], res);
+    }
+    /**键的剩余生存时间（毫秒），键不存在时为-2，没有设置过期时间时为-1**/
+    int pttl(const string& key, int64& res)
+    {
+        if (execute("pttl", key) > 0) res = number;
+
+        return code;
+    }
+    /**当前数据库的键数量**/
+    int dbsize(int64& res)
+    {
+        if (execute("dbsize") > 0) res = number;
+
+        return code;
+    }
+
+    int expire(const string& key, int timeout)
+    {
+        return execute(Header::EXPIRE, key, timeout);
+    }
+    /**返回所有 key，返回的key存放在vec中**/
+    int keys(vector<string>& vec, const string& key)
+    {
+        return execute(vec, "keys", key);
+    }
+    /**哈希数据删除field**/
+    int hdel(const string& key, const string& field)
+    {
+        return execute(Header::HDEL, key, field);
+    }
+    /**哈希数据获取field对应的value**/
+    int hget(const string& key, const string& field, string& val)
+    {
+        if (execute(views, Header::HGET, key, field) <= 0) return code;
+
+        return uncompress(views[0], val);
+    }
+
+    /**设置key，根据timout执行 setex还是set**/
+    int set(const string & key,const string & val,int timeout = 0){
+        string tmp;
+        const string & data = compress(val,tmp);
+
+        return timeout > 0 ? execute(Header::SETEX,key,timeout,data) : execute(Header::SET,key,data);
+    }
+    /**哈希数据设置field与对应的value**/
+    int hset(const string & key,const string & field,const string & val){
+        string tmp;
+
+        return execute(Header::HSET,key,field,compress(val,tmp));
+    }
+
+protected:
+    /**按 COMPRESS_TYPE 压缩长度不小于 COMPRESS_THRESHOLD 的值，压缩结果放在 tmp 中，不需要压缩时返回原值**/
+    static const string & compress(const string & val,string & tmp){
+        if (COMPRESS_TYPE == RedisCompress::NONE || (int)(val.length()) < COMPRESS_THRESHOLD) return val;
+
+        return RedisCompress::Compress(COMPRESS_TYPE,COMPRESS_LEVEL,val,tmp) ? tmp : val;
+    }
+    /**COMPRESS_TYPE 不是 NONE 时，读取到的值带有压缩标记就解压，解压失败时返回 DATAERR。
+     * 不开启压缩时按原样返回，以 "\0RZ" 开头的二进制值不会被误当作压缩数据；
+     * 所以压缩保存的值，读取时也要开启压缩（算法可以不同，按头部记录的算法解压）。**/
+    int uncompress(string & data,string & val){
+        int res = COMPRESS_TYPE == RedisCompress::NONE ? 0 : RedisCompress::Uncompress(data,val);
+
+        if (res == 0){
+            val.swap(data);
+        } else if (res < 0){
+            msg = "uncompress failed";
+            code = DATAERR;
+        }
+
+        return code;
+    }
+    /**同上，值复制到 val 中，val 已有的内存可以复用**/
+    int uncompress(string_view data,string & val){
+        int res = COMPRESS_TYPE == RedisCompress::NONE ? 0 : RedisCompress::Uncompress(data,val);
+
+        if (res == 0){
+            val.assign(data.data(),data.size());
+        } else if (res < 0){
+            msg = "uncompress failed";
+            code = DATAERR;
+        }
+
+        return code;
+    }
+
+public:
+    /**列表数据删除，弹出数据，调用lpop，也就是左边弹出**/
+    int pop(const string & key,string & val){
+        return lpop(key,val);
+    }
+    /**列表左弹出**/
+    int lpop(const string & key,string & val){
+        if (execute(views,"lpop",key) <= 0) return code;
+        val.assign(views[0].data(),views[0].size());
+        return code;
+    }
+    /**列表右弹出**/
+    int rpop(const string& key, string& val)
+    {
+        if (execute(views, "rpop", key) <= 0) return code;
+
+        val.assign(views[0].data(), views[0].size());
+
+        return code;
+    }
+    /**列表数据增加，添加数据**/
+    int pust(const string & key,const string & val){
+        return rpush(key,val);
+    }
+    /**左添加**/
+    int lpush(const string & key,const string & val){
+        return execute("lpush",key,val);
+    }
+    /**右添加**/
+    int rpush(const string & key,const string & val){
+        return execute("rpush",key,val);
+    }
+    /**列表数据查看，start与end之间的数据，左闭右闭**/
+    int range(vector<string> & vec,const string & key,int start,int end){
+        return execute(vec,"lrange",key,start,end);
+    }
+    /**lrange**/
+    int lrange(vector<string> & vec,const string & key,int start,int end){
+        return execute(vec,"lrange",key,start,end);
+    }
+    /**同上，结果指向连接的内存块，在下一条命令之前有效**/
+    int lrange(vector<string_view> & vec,const string & key,int start,int end){
+        return execute(vec,"lrange",key,start,end);
+    }
+
+public:
+    /**阻塞的列表弹出，按顺序检查 keys 中的列表，从第一个非空列表的左边弹出，key 返回弹出数据的列表。
+     * wait 是最长等待时间（毫秒），0表示一直等待，等待超时返回 NOTFUND。
+     * 阻塞期间连接不能执行其他命令，应该在 Create 创建的独立连接上调用，等待期间不产生任何命令。**/
+    int blpop(const vector<string> & keys,int wait,string & key,string & val){
+        return executePop("blpop",keys,wait,key,val);
+    }
+    int blpop(const string & key,int wait,string & val){
+        string tmp;
+        return executePop("blpop",{key},wait,tmp,val);
+    }
+    /**同 blpop，从列表的右边弹出**/
+    int brpop(const vector<string> & keys,int wait,string & key,string & val){
+        return executePop("brpop",keys,wait,key,val);
+    }
+    int brpop(const string & key,int wait,string & val){
+        string tmp;
+        return executePop("brpop",{key},wait,tmp,val);
+    }
+    /**阻塞地从 src 弹出一个元素并放入 dest，from、to 是 "left" 或 "right"，用于可靠队列（先移入处理中列表，处理完再删除）。
+     * 需要 redis 6.2 以上，等待超时返回 NOTFUND。**/
+    int blmove(const string & src,const string & dest,int wait,string & val,const string & from = "left",const string & to = "right"){
+        Command cmd("blmove");
+        cmd.add(src,dest,from,to);
+        cmd.add(wait / 1000.0);
+        /**超时返回空值（$-1 或 *-1），*-1 解析后没有元素，返回值是0而不是 NOTFUND**/
+        if (executeBlocking(cmd,wait) < 0) return code;
+        if (cmd.res.empty()) return code = NOTFUND;
+
+        val.swap(cmd.res[0]);
+
+        return code = OK;
+    }
+
+protected:
+    int executePop(const char * name,const vector<string> & keys,int wait,string & key,string & val){
+        if (keys.empty()) return code = PARAMERR;
+
+        Command cmd(name);
+
+        for (const string & item : keys) cmd.add(item);
+
+        cmd.add(wait / 1000.0);
+        /**超时返回空数组 *-1**/
+        if (executeBlocking(cmd,wait) < 0) return code;
+        if (cmd.res.size() < 2) return code = NOTFUND;
+
+        key.swap(cmd.res[0]);
+        val.swap(cmd.res[1]);
+
+        return code = OK;
+    }
+    /**执行阻塞命令，wait 是服务端最长的阻塞时间（毫秒），0表示一直阻塞，客户端的超时时间在此基础上再加上 timeout。
+     * 等待期间把 socket 的接收超时临时调大到 BLOCK_RECV_TIMEOUT，减少空闲时的唤醒次数。
+     * 客户端超时后服务端仍然可能返回结果，连接上的响应会错位，所以超时后关闭连接。**/
+    int executeBlocking(Command & cmd,int wait){
+        int step = max(SOCKET_TIMEOUT,BLOCK_RECV_TIMEOUT);
+
+        if (step != waitstep) sock.setRecvTimeout(waitstep = step);
+
+        int res = cmd.getResult(this,wait > 0 ? timeout + wait : numeric_limits<int>::max() / 2);
+
+        if (res == TIMEOUT) sock.close();
+
+        if (!sock.isClosed()) sock.setRecvTimeout(waitstep = SOCKET_TIMEOUT);
+
+        return res;
+    }
+
+public:
+    /**有序数组删除**/
+    int zrem(const string & key,const string & field){
+        return execute("zrem",key,field);
+    }
+
+    int zadd(const string & key,const string & field,double score){
+        return execute("zadd",key,score,field);
+    }
+
+    int zrange(vector<string> & vec,const string & key,int start,int end,bool withsore = false){
+        return withsore ? execute(vec,"zrange",key,start, end,"withscores") : execute(vec,"zrange",key,start,end);
+    }
+    /**成员的分数，成员不存在时返回 NOTFUND**/
+    int zscore(const string & key,const string & field,double & score){
+        vector<string> vec;
+
+        if (execute(vec,"zscore",key,field) <= 0) return code;
+
+        return parseNumber(vec[0],score);
+    }
+    /**有序集合的成员数量**/
+    int zcard(const string & key,int64 & res){
+        if (execute("zcard",key) > 0) res = number;
+
+        return code;
+    }
+    /**分数自增，res 返回自增后的分数**/
+    int zincrby(const string & key,const string & field,double val,double & res){
+        vector<string> vec;
+
+        if (execute(vec,"zincrby",key,val,field) <= 0) return code;
+
+        return parseNumber(vec[0],res);
+    }
+    /**一条 ZADD 命令添加多个成员，getNumber 返回新增的成员数量**/
+    int zadd(const string & key,const vector<pair<string,double>> & items){
+        if (items.empty()) return code = PARAMERR;
+
+        Command cmd("zadd");
+        cmd.add(key);
+
+        for (const auto & item : items) cmd.add(item.second,item.first);
+
+        return cmd.getResult(this,timeout);
+    }
+    /**带分数的 zrange，成员和分数成对返回，分数在读取时直接解析**/
+    int zrange(RedisPairs<double> & res,const string & key,int64 start,int64 end){
+        return executePairs(res,"zrange",key,start,end,"withscores");
+    }
+    /**带分数的 zrevrange，按分数从高到低返回**/
+    int zrevrange(RedisPairs<double> & res,const string & key,int64 start,int64 end){
+        return executePairs(res,"zrevrange",key,start,end,"withscores");
+    }
+    /**分数在 [min, max] 之间的成员，count 小于0表示不限制数量**/
+    int zrangebyscore(RedisPairs<double> & res,const string & key,double min,double max,int64 offset = 0,int64 count = -1){
+        if (offset == 0 && count < 0) return executePairs(res,"zrangebyscore",key,min,max,"withscores");
+
+        return executePairs(res,"zrangebyscore",key,min,max,"withscores","limit",offset,count);
+    }
+
+public:
+    /**一条 HSET 命令设置多个字段，getNumber 返回新增的字段数量。
+     * 值按原样保存，不经过 COMPRESS_TYPE 压缩，方便和 hgetall 配合使用。**/
+    int hset(const string & key,const vector<pair<string,string>> & items){
+        if (items.empty()) return code = PARAMERR;
+
+        Command cmd("hset");
+        cmd.add(key);
+
+        for (const auto & item : items) cmd.add(item.first,item.second);
+
+        return cmd.getResult(this,timeout);
+    }
+    /**读取哈希的所有字段，字段名和值都指向 res 内部连续的内存，哈希不存在时 res 为空**/
+    int hgetall(RedisPairs<string_view> & res,const string & key){
+        return executePairs(res,"hgetall",key);
+    }
+
+protected:
+    /**执行返回成对数组的命令，数组元素直接追加到 res 的连续内存中**/
+    template<class T,class ...ARGS>
+    int executePairs(RedisPairs<T> & res,const ARGS & ...args){
+        Command & cmd = prepare();
+
+        res.clear();
+        arenaoffsets.clear();
+        cmd.flat = &res.data;
+        cmd.offsets = &arenaoffsets;
+        cmd.encode(args...);
+
+        if (cmd.getResult(this,timeout) < 0) return code;
+
+        if (!res.load(arenaoffsets)){
+            res.clear();
+            msg = "invalid number";
+            return code = DATAERR;
+        }
+
+        return code;
+    }
+
+protected:
+    /**用 from_chars 解析字符串形式的数值响应（INCRBYFLOAT、ZSCORE 等），格式错误时返回 DATAERR**/
+    template<class T>
+    int parseNumber(string & str,T & val){
+        if (!RedisField<T>::Decode(str,val)){
+            msg = "invalid number";
+            return code = DATAERR;
+        }
+
+        return code;
+    }
+
+public:
+    /**向流中添加一条消息，id 返回服务端生成的消息 id。
+     * maxlen 大于0时附带 MAXLEN ~ maxlen，由服务端按整个宏节点近似裁剪，比精确裁剪的开销小得多。**/
+    int xadd(const string & key,const vector<pair<string,string>> & fields,string & id,int64 maxlen = 0){
+        if (fields.empty()) return code = PARAMERR;
+
+        Command cmd("xadd");
+        cmd.add(key);
+
+        if (maxlen > 0) cmd.add("maxlen","~",maxlen);
+
+        cmd.add("*");
+
+        for (const auto & item : fields) cmd.add(item.first,item.second);
+
+        if (cmd.getResult(this,timeout) > 0) id = cmd.res[0];
+
+        return code;
+    }
+    /**流的消息数量**/
+    int xlen(const string & key,int64 & res){
+        if (execute("xlen",key) > 0) res = number;
+
+        return code;
+    }
+    /**创建消费组，mkstream 为 true 时流不存在则创建空流，消费组已经存在时同样返回 OK**/
+    int xgroupCreate(const string & key,const string & group,const string & id = "$",bool mkstream = true){
+        int res = mkstream ? execute("xgroup","create",key,group,id,"mkstream") : execute("xgroup","create",key,group,id);
+
+        if (res == FAIL && msg.compare(0,9,"BUSYGROUP") == 0) return code = OK;
+
+        return res;
+    }
+    /**以消费组的方式读取消息，返回读取到的消息数。
+     * block 大于等于0时阻塞等待最多 block 毫秒（0表示一直等待），等待期间不计入命令超时，
+     * 阻塞读取会长时间占用连接，应该在 Create 创建的独立连接上执行。
+     * id 为 ">" 时读取新消息，为 "0" 时读取本消费者已经领取但还没有确认的消息。**/
+    int xreadgroup(vector<RedisStreamEntry> & vec,const string & group,const string & consumer,const string & key,int count = 100,int block = -1,const string & id = ">"){
+        RedisReply reply;
+        Command cmd("xreadgroup");
+
+        cmd.add("group",group,consumer);
+        cmd.add("count",count);
+
+        if (block >= 0) cmd.add("block",block);
+
+        cmd.add("streams",key,id);
+        cmd.tree = &reply;
+        vec.clear();
+
+        int res = block >= 0 ? executeBlocking(cmd,block) : cmd.getResult(this,timeout);
+
+        /**阻塞超时没有消息时返回空值**/
+        if (res == NOTFUND) return code = 0;
+        if (res < 0) return res;
+
+        for (RedisReply & stream : reply.elements){
+            if (stream.elements.size() < 2) continue;
+
+            for (RedisReply & item : stream.elements[1].elements){
+                vec.emplace_back();
+
+                if (!vec.back().load(item)) vec.pop_back();
+            }
+        }
+
+        return code = vec.size();
+    }
+    /**批量确认消息，getNumber 返回确认成功的数量**/
+    int xack(const string & key,const string & group,const vector<string> & ids){
+        if (ids.empty()) return code = OK;
+
+        Command cmd("xack");
+        cmd.add(key,group);
+
+        for (const string & id : ids) cmd.add(id);
+
+        return cmd.getResult(this,timeout);
+    }
+    /**把空闲超过 minidle 毫秒的待确认消息转给 consumer，用于恢复崩溃的消费者没有确认的消息。
+     * 从 start 开始扫描，next 返回下一次扫描的起点，为 "0-0" 时表示已经扫描完一轮；返回转移的消息数。**/
+    int xautoclaim(vector<RedisStreamEntry> & vec,string & next,const string & key,const string & group,const string & consumer,int64 minidle,const string & start = "0-0",int count = 100){
+        RedisReply reply;
+        Command cmd("xautoclaim");
+
+        cmd.add(key,group,consumer);
+        cmd.add(minidle);
+        cmd.add(start,"count",count);
+        cmd.tree = &reply;
+        vec.clear();
+
+        if (cmd.getResult(this,timeout) < 0) return code;
+
+        if (reply.elements.size() < 2) return code = DATAERR;
+
+        next = reply.elements[0].str;
+
+        for (RedisReply & item : reply.elements[1].elements){
+            vec.emplace_back();
+
+            if (!vec.back().load(item)) vec.pop_back();
+        }
+
+        return code = vec.size();
+    }
+
+public:
+    /**把对象的字段写入哈希（HSET key field value ...），对象的类型需要有 RedisCodec 特化，字段值按 RedisField 转换**/
+    template<class T>
+    int hsetObject(const string & key,const T & obj){
+        Command cmd("hset");
+        cmd.add(key);
+        RedisObject::ToHash(obj,cmd.vec);
+        return cmd.getResult(this,timeout);
+    }
+    /**用 HGETALL 读取哈希并填充对象的字段，哈希不存在时返回 NOTFUND，字段值格式错误时返回 DATAERR**/
+    template<class T>
+    int hgetObject(const string & key,T & obj){
+        Command cmd("hgetall");
+        cmd.add(key);
+
+        if (cmd.getResult(this,timeout) < 0) return code;
+        if (cmd.res.empty()) return code = NOTFUND;
+
+        if (RedisObject::FromHash(cmd.res,obj) < 0){
+            msg = "decode object failed";
+            return code = DATAERR;
+        }
+
+        return code;
+    }
+    /**把对象打包成二进制数据后作为字符串保存，经过 set，所以同样会按 COMPRESS_TYPE 压缩。
+     * 开启压缩时，打包结果恰好以压缩标记 "\0RZ" 开头且不小于 RedisCompress::HEAD_SIZE 字节的对象
+     * （比如第一个成员是值为 0x5A5200 的整数）读取时会被当作压缩数据，getObject 返回 DATAERR，
+     * 这种对象应该在不开启压缩的连接上读写，或者调整成员顺序。**/
+    template<class T>
+    int setObject(const string & key,const T & obj,int timeout = 0){
+        string val;
+        RedisObject::Pack(obj,val);
+        return set(key,val,timeout);
+    }
+    /**读取 setObject 保存的对象，数据与对象的结构不匹配时返回 DATAERR**/
+    template<class T>
+    int getObject(const string & key,T & obj){
+        string val;
+
+        if (get(key,val) < 0) return code;
+
+        if (!RedisObject::Unpack(val,obj)){
+            msg = "unpack object failed";
+            return code = DATAERR;
+        }
+
+        return code;
+    }
+
+public:
+    /**流式写入：命令的最后一个参数（一般是值）由 reader 分块提供，不需要把整个值放在一个 string 中，也不受 memsz 限制。
+     * reader(buffer, len) 向 buffer 中写入最多 len 个字节，返回写入的字节数，小于等于0表示读取失败；
+     * 一共需要提供 size 个字节，中途失败时连接上的命令已经不完整，连接会被关闭。**/
+    int executeStream(Command & cmd,int64 size,function<int(char *,int)> reader){
+        int64 sent = 0;
+        int res = writeStreamHead(cmd,size);
+
+        while (res >= 0 && sent < size){
+            int len = reader(buffer,(int)(min<int64>(memsz,size - sent)));
+
+            if (len <= 0 || len > size - sent){
+                res = IOERR;
+                break;
+            }
+
+            res = sock.write(buffer,len);
+            sent += len;
+        }
+
+        return finishStream(cmd,res);
+    }
+    /**流式读取：执行命令并把批量字符串响应（如 GET 的结果）分块交给 sink，每块最多 memsz 个字节，内存占用与值的大小无关。
+     * sink 返回 false 表示停止读取，剩余的数据无法再读取，连接会被关闭。
+     * 响应不是批量字符串时（错误、键不存在等）按普通命令处理。**/
+    int executeStream(Command & cmd,function<bool(const char *,int)> sink){
+        int len = 0;
+        int delay = 0;
+        int readed = 0;
+        const char * end = NULL;
+        string msg = cmd.toString();
+
+        cmd.status = 0;
+        cmd.msg.clear();
+        cmd.res.clear();
+
+        if (sock.write(msg.c_str(),msg.length()) < 0) return cmd.finish(this,NETERR);
+        /**读取响应的第一行，批量字符串是 $size\r\n**/
+        while (readed == 0 || (end = (const char *)(memchr(buffer,'\n',readed))) == NULL){
+            if (readed >= memsz) return cmd.finish(this,DATAERR);
+            if ((len = sock.read(buffer + readed,memsz - readed,false)) < 0) return cmd.finish(this,len);
+
+            if (len == 0){
+                if ((delay += SOCKET_TIMEOUT) > timeout) return cmd.finish(this,TIMEOUT);
+            } else{
+                delay = 0;
+                readed += len;
+            }
+        }
+
+        int64 size = *buffer == '$' ? atoll(buffer + 1) : -1;
+
+        if (size < 0) return cmd.finish(this,cmd.read(this,timeout,readed));
+
+        int tail = 2;  /**值后面的 \r\n**/
+        int64 left = size;
+        /**处理缓冲区中的一块数据，值的部分交给 sink，剩余的部分是结尾的 \r\n**/
+        auto consume = [&](const char * data,int len){
+            int num = (int)(min<int64>(len,left));
+
+            if (num > 0 && !sink(data,num)) return false;
+
+            left -= num;
+            tail -= min(len - num,tail);
+
+            return true;
+        };
+
+        int pos = end + 1 - buffer;
+
+        if (!consume(buffer + pos,readed - pos)){
+            sock.close();
+            return cmd.finish(this,IOERR);
+        }
+
+        delay = 0;
+
+        while (left > 0 || tail > 0){
+            if ((len = sock.read(buffer,(int)(min<int64>(memsz,left + tail)),false)) < 0) return cmd.finish(this,len);
+
+            if (len == 0){
+                if ((delay += SOCKET_TIMEOUT) > timeout) return cmd.finish(this,TIMEOUT);
+                continue;
+            }
+
+            delay = 0;
+
+            if (!consume(buffer,len)){
+                sock.close();
+                return cmd.finish(this,IOERR);
+            }
+        }
+
+        cmd.status = OK;
+
+        return cmd.finish(this,OK);
+    }
+    /**流式设置键值，值的内容由 reader 分块提供**/
+    int setStream(const string & key,int64 size,function<int(char *,int)> reader){
+        Command cmd("set");
+        cmd.add(key);
+        return executeStream(cmd,size,reader);
+    }
+    /**流式获取键值，值的内容分块交给 sink。流式读写不做压缩，开启压缩时读到 set 压缩过的值返回 DATAERR，
+     * 不会调用 sink；开启压缩时前 HEAD_SIZE 字节先缓存起来检查压缩标记**/
+    int getStream(const string & key,function<bool(const char *,int)> sink){
+        Command cmd("get");
+        cmd.add(key);
+
+        if (COMPRESS_TYPE == RedisCompress::NONE) return executeStream(cmd,sink);
+
+        string head;
+        bool checked = false;
+        bool compressed = false;
+
+        int res = executeStream(cmd,[&](const char * data,int len){
+            if (compressed) return true;
+            if (checked) return sink(data,len);
+
+            int num = min(len,RedisCompress::HEAD_SIZE - (int)(head.length()));
+
+            head.append(data,num);
+
+            if ((int)(head.length()) < RedisCompress::HEAD_SIZE) return true;
+
+            checked = true;
+
+            /**读完剩下的数据再返回，保持连接可用**/
+            if (RedisCompress::IsCompressed(head)) return compressed = true;
+
+            return sink(head.c_str(),head.length()) && (num == len || sink(data + num,len - num));
+        });
+
+        if (compressed && res == OK){
+            msg = "compressed value";
+            return code = DATAERR;
+        }
+
+        /**值比 HEAD_SIZE 短时在这里交给 sink**/
+        if (res == OK && !checked && head.length() > 0 && !sink(head.c_str(),head.length())) return code = IOERR;
+
+        return res;
+    }
+    /**把文件的内容设置为键值，linux 下使用 sendfile 直接从文件发送到socket**/
+    int setFile(const string & key,const string & path){
+        Command cmd("set");
+        cmd.add(key);
+#ifdef LINUX
+        struct stat st;
+        int fd = ::open(path.c_str(),O_RDONLY);
+
+        cmd.status = 0;
+        cmd.msg.clear();
+
+        if (fd < 0 || fstat(fd,&st) < 0){
+            if (fd >= 0) ::close(fd);
+            return cmd.finish(this,IOERR);
+        }
+
+        int res = writeStreamHead(cmd,st.st_size);
+
+        if (res >= 0){
+            int64 num = sock.sendfile(fd,0,st.st_size);
+            if (num < 0) res = (int)(num);
+        }
+
+        ::close(fd);
+
+        return finishStream(cmd,res);
+#else
+        FILE * fp = fopen(path.c_str(),"rb");
+
+        if (fp == NULL) return cmd.finish(this,IOERR);
+
+        fseek(fp,0,SEEK_END);
+        int64 size = ftell(fp);
+        fseek(fp,0,SEEK_SET);
+
+        int res = executeStream(cmd,size,[fp](char * data,int len){
+            return (int)(fread(data,1,len,fp));
+        });
+
+        fclose(fp);
+
+        return res;
+#endif
+    }
+    /**把键值写入文件，键不存在时不会创建文件**/
+    int getFile(const string & key,const string & path){
+        FILE * fp = NULL;
+
+        int res = getStream(key,[&](const char * data,int len){
+            if (fp == NULL && (fp = fopen(path.c_str(),"wb")) == NULL) return false;
+            return fwrite(data,1,len,fp) == (size_t)(len);
+        });
+
+        if (fp){
+            fclose(fp);
+        } else if (res == OK){
+            /**空字符串不会调用 sink，这里创建空文件**/
+            if ((fp = fopen(path.c_str(),"wb")) == NULL) return IOERR;
+            fclose(fp);
+        }
+
+        return res;
+    }
+
+protected:
+    /**写入流式命令的头部：除最后一个参数外的所有参数，以及最后一个参数的长度 $size\r\n**/
+    int writeStreamHead(Command & cmd,int64 size){
+        string msg = "*" + to_string(cmd.vec.size() + 1) + "\r\n";
+
+        for (const string & item : cmd.vec) msg += "$" + to_string(item.length()) + "\r\n" + item + "\r\n";
+
+        msg += "$" + to_string(size) + "\r\n";
+
+        cmd.status = 0;
+        cmd.msg.clear();
+        cmd.res.clear();
+
+        return sock.write(msg.c_str(),msg.length());
+    }
+    /**写入流式命令结尾的 \r\n 并读取响应，命令没有完整写入时关闭连接**/
+    int finishStream(Command & cmd,int res){
+        if (res >= 0) res = sock.write("\r\n",2);
+
+        if (res < 0){
+            sock.close();
+            return cmd.finish(this,res);
+        }
+
+        int readed = 0;
+
+        return cmd.finish(this,cmd.read(this,timeout,readed));
+    }
+public:
+    /**这个重载用于执行 Lua 脚本，而不涉及键（KEYS）和参数（ARGV）数组。这是一个最基本的执行 Lua 脚本的方式。**/
+    template<class ...ARGS>
+    int eval(const string & lua){
+        vector<string> vec;
+        return eval(lua,vec);
+    }
+
+    /**调用下面的eval
+     * 这个重载允许执行 Lua 脚本，并传递一个键（KEYS[1]）和参数（ARGV[1]）给 Lua 脚本。在这种情况下，key 是唯一的键，args 可以是零个或多个附加参数。**/
+    template<class ...ARGS>
+    int eval(const string & lua,const string & key,ARGS ...args){
+        vector<string> vec;
+        vec.emplace_back(key);
+        return eval(lua,vec,args...);
+    }
+    /**调用下面的eval
+     * 这个重载允许执行 Lua 脚本，并传递一个键数组（KEYS）以及参数（ARGV）给 Lua 脚本。这样可以传递多个键，也可以传递零个或多个附加参数。**/
+    template<class ...ARGS>
+    int eval(const string & lua,const vector<string> & keys,ARGS ...args){
+        vector<string> vec;
+        return eval(vec,lua,keys,args...);
+    }
+    /**这个重载是最通用的，它允许传递自定义的键数组和参数到 Lua 脚本，并将执行结果存储在 vec 中。**/
+    template<class ...ARGS>
+    int eval(vector<string> & vec,const string & lua,const vector<string> & keys,ARGS ...args){
+        int len = 0;
+        Command cmd("eval");
+        cmd.add(lua);
+        cmd.add(len = keys.size());
+//        int len1 = cmd.vec.size();
+
+        if (len-- > 0){
+            for (int i = 0; i < len; ++i) {
+                cmd.add(keys[i]);
+            }
+            /**之所以这么写，是因为add()没有单独添加额外参数的重载形式，
+             * 调用void add(DATA_TYPE val,ARGS ...args){**/
+            cmd.add(keys.back(),args...);
+        }
+//        len1 = cmd.vec.size();
+
+        cmd.getResult(this,timeout);
+        if (code > 0) swap(vec,cmd.res);
+
+        return code;
+    }
+
+    string get(const string & key){
+        string res;
+        get(key,res);
+        return res;
+    }
+
+    string hget(const string & key,const string & field){
+        string res;
+        hget(key,field,res);
+        return res;
+    }
+
+    const char * getLockId() {
+        /**定义了一个线程局部的字符数组id，用于存储锁的唯一标识符。
+         * 使用 thread_local 保证了锁的唯一标识符对于每个线程是独立的，避免了线程之间的竞争和冲突。**/
+        thread_local char id[0xFF] = {};
+        auto GetHost = []() {
+            char hostname[0xFF];
+            /**获取当前主机的名称，存储在hostname中**/
+            if (gethostname(hostname, sizeof(hostname)) < 0) return "unkonw host";
+            /**根据主机名获取主机的IP地址信息，存储在data中。通常用于进行网络编程中的主机名解析。
+             * gethostbyname() 函数返回一个 struct hostent 结构指针，其中包含了与指定主机名相关的信息，包括 IP 地址。这个结构通常包括以下字段：
+                h_name：官方主机名。                               "Present"
+                h_aliases：主机的别名列表。
+                h_addrtype：地址类型（通常为 AF_INET，表示 IPv4）。   2
+                h_length：地址的字节数。                            4
+                h_addr_list：主机的 IP 地址列表。通常，IP 地址以二进制形式表示，可以通过 inet_ntoa() 函数将其转换为字符串。
+             **/
+            struct hostent *data = gethostbyname(hostname);
+            /**将IP地址转换为字符串格式，返回主机的IP地址。**/
+            return (const char *) inet_ntoa(*(struct in_addr *) (data->h_addr_list[0]));
+        };
+
+        if (*id == 0){
+#ifdef LINUX
+            /**将主机名（或IP地址）、当前进程ID和当前线程ID等信息格式化成一个字符串，并将其存储在id中。这个字符串将作为锁的唯一标识符。**/
+            snprintf(id, sizeof(id)-1,"%s:%ld:%ld",GetHost(),(long)getpid(),(long) syscall(SYS_gettid));
+#else
+            snprintf(id, sizeof(id) - 1, "%s:%ld:%ld", GetHost(), (long)GetCurrentProcessId(), (long)GetCurrentThreadId());
+#endif
+        }
+        return id;
+    }
+    /**
+    这段代码是用来实现分布式锁的解锁操作。解锁的关键在于确保只有持有锁的客户端才能够释放锁，而其他客户端不能随意释放锁。
+
+    通过 Lua 脚本执行 Redis 命令。
+
+    redis.call 是 Redis Lua 脚本中的一个内建函数，用于调用 Redis 命令。在 Lua 脚本中，可以使用 redis.call 来执行 Redis 命令，
+     就像在普通的 Redis 命令行中执行一样。例如redis.call('get', 'mykey')。这允许你在 Lua 脚本中利用 Redis 数据存储和处理的能力。
+
+     KEYS 是 Lua 脚本中的一个特殊数组，用于表示传递给 Lua 脚本的 Redis 键。在 Redis Lua 脚本中，
+     KEYS 数组允许你引用传递给脚本的 Redis 键（key）。KEYS 数组的索引从 1 开始。
+     在这里KEYS[1] 的含义是使用传递给脚本的第一个 Redis 键，通常在解锁分布式锁的情况下，KEYS[1] 将包含用于加锁的键。通过使用 KEYS[1]，
+     你可以在 Lua 脚本中引用和操作这个键，例如检查它的值是否与你期望的值相匹配，然后执行相应的操作，例如删除该键。
+
+     ARGV 是 Lua 脚本中的另一个特殊数组，用于表示传递给 Lua 脚本的参数。与 KEYS 数组类似，ARGV 允许你引用传递给脚本的参数。
+     同样，Lua 数组的索引从 1 开始。
+     在你的 Lua 脚本中，ARGV[1] 表示使用传递给脚本的第一个参数，即数组的第一个元素。通常情况下，ARGV[1] 包含了用于解锁分布式锁的信息，
+     通常是加锁时设置的标识，以确保只有持有相同标识的客户端才能成功解锁。
+
+    通过这个 Lua 脚本，只有持有锁的客户端才能够成功解锁，其他客户端无法释放锁。这是一种非常安全且保证锁的一致性的解锁方式。
+     **/
+    bool unlock(const string & key){
+        const char * lua  = "if redis.call('get',KEYS[1])==ARGV[1] then return redis.call('del',KEYS[1]) else return 0 end";
+        return eval(lua,key,getLockId()) > 0 && status == OK;
+    }
+
+    /**一个键（用于标识锁）和一个超时时间（默认为30秒）作为参数**/
+    bool lock(const string & key,int timeout=30){
+        /**将传入的超时时间转换为毫秒**/
+        int delay = timeout * 1000;
+        for (int i = 0; i < delay; i+=10) {
+            if (execute("set",key,getLockId(),"nx","ex",timeout) >= 0) return true;
+//            sleep(10);
+            Sleep(10);
+        }
+        return false;
+    }
+
+
+protected:
+    /** [捕获列表] (参数列表) -> 返回值类型 {
+            // 函数体
+        }
+     * Lambda 表达式的捕获列表用于指定在 Lambda 内部可以访问的外部变量。捕获列表的形式为 []，在括号内可以使用以下不同的方式来指定捕获变量：
+    不捕获任何变量：[]，表示 Lambda 不会访问任何外部变量。
+    捕获所有变量（按值捕获）：[=]，表示 Lambda 可以访问当前作用域内的所有变量，但是它们会被按值捕获，Lambda 内部对这些变量的修改不会影响外部。
+    捕获所有变量（按引用捕获）：[&]，表示 Lambda 可以访问当前作用域内的所有变量，它们会被按引用捕获，Lambda 内部对这些变量的修改会影响外部。
+    指定捕获的变量：[x, y]，表示只捕获 x 和 y 两个变量。
+    按值捕获指定变量：[=, &x]，表示按值捕获所有变量，但 x 会按引用捕获。
+    按引用捕获指定变量：[&, y]，表示按引用捕获所有变量，但 y 会按值捕获。
+    指定捕获变量并设置它们的捕获方式：[x, &y]，表示只捕获 x 和 y 两个变量，其中 x 按值捕获，y 按引用捕获。**/
+    virtual shared_ptr<RedisConnect> grasp() const{
+
+        ResPool<RedisConnect> & pool = GetPool();
+
+        /**获取一个redis连接，失效的连接移出连接池后继续获取。
+         * 服务端不可用时连接池中的连接都会失效，移除后由 Create 建立新连接，熔断期间 Create 直接失败，这里也就立即返回 NULL。**/
+        shared_ptr<RedisConnect> redis;
+
+        while ((redis = pool.get()) && redis->isBroken()) pool.disable(redis);
+
+        return redis;
+    }
+
+    /**静态初始化一个连接池ResPool<RedisConnect>  由后面的lambda函数初始化。
+     * 调用的构造函数是     ResPool(function<shared_ptr<T>()> func, int maxlen = 8, int timeout = 60)
+                        {
+                            this->timeout = timeout;
+                            this->maxlen = maxlen;
+                            this->func = func;  这个形参对应的实参是lambda函数
+                        }
+     * 连接池使用 GetTemplate() 中保存的配置创建连接，Setup 需要通过它预热连接池，所以放在静态函数中。**/
+    static ResPool<RedisConnect> & GetPool(){
+        static ResPool<RedisConnect> pool([](){
+            return Create();
+        },POOL_MAXLEN);
+
+        return pool;
+    }
+
+public:
+    /**按 Setup 的配置创建一个不属于连接池的独立连接，失败时返回 NULL。
+     * 用于阻塞命令（xreadgroup、blpop 等）和长时间占用的连接，不会占用连接池的名额。**/
+    static shared_ptr<RedisConnect> Create(){
+        RedisConnect * tmpl = GetTemplate();
+
+        return Create(tmpl->host,tmpl->port);
+    }
+    /**同上，连接到指定的地址（例如副本），密码、超时、缓冲区大小和 socket 选项使用 Setup 的配置。**/
+    static shared_ptr<RedisConnect> Create(const string & host,int port){
+        /**创建了一个名为 redis 的智能指针，指向了一个新创建的 RedisConnect 对象，并使用 make_shared 函数进行初始化。
+         * make_shared 是 C++ 中用于创建智能指针的函数，它会动态分配内存来存储对象，并返回一个指向该对象的智能指针。**/
+        RedisConnect * tmpl = GetTemplate();
+        RedisBreaker * breaker = tmpl->breaker && tmpl->host == host && tmpl->port == port ? tmpl->breaker : RedisBreaker::Get(host,port);
+        /**熔断期间直接返回 NULL，不再尝试建立连接**/
+        if (!breaker->acquire()) return NULL;
+        shared_ptr<RedisConnect> redis = make_shared<RedisConnect>();
+        bool connected = redis && redis->connect(host,port,tmpl->timeout,tmpl->memsz,tmpl->option);
+        breaker->release(connected);
+        if (connected){
+            if (redis->auth(tmpl->passwd) > 0) return redis;
+        }
+        return redis = NULL;
+    }
+    /**按 Setup 的配置同时建立 count 个连接，用于连接池的预热和补充。
+     * 所有连接的握手在同一个 poll 中等待，AUTH 也是先全部发出再依次读取结果，总耗时约等于建立一个连接的时间。
+     * 成功的连接追加到 vec 中，返回成功的数量。**/
+    static int Create(int count,vector<shared_ptr<RedisConnect>> & vec){
+        vector<SOCKET> socks;
+        RedisConnect * tmpl = GetTemplate();
+        RedisBreaker * breaker = tmpl->breaker;
+
+        if (count <= 0 || (breaker && !breaker->acquire())) return 0;
+
+        Socket::SocketConnectBatch(tmpl->host,tmpl->port,tmpl->timeout,count,socks);
+
+        if (breaker) breaker->release(socks.size() > 0);
+
+        vector<shared_ptr<RedisConnect>> list;
+
+        for (SOCKET sock : socks){
+            shared_ptr<RedisConnect> redis = make_shared<RedisConnect>();
+
+            redis->sock.attach(sock);
+            redis->init(tmpl->host,tmpl->port,tmpl->timeout,tmpl->memsz,tmpl->option);
+            redis->passwd = tmpl->passwd;
+
+            list.push_back(redis);
+        }
+
+        if (tmpl->passwd.length() > 0){
+            for (shared_ptr<RedisConnect> & redis : list){
+                Command & cmd = redis->prepare();
+                cmd.encode("auth",tmpl->passwd);
+                if (redis->sock.write(cmd.encoded().c_str(),cmd.encoded().length()) < 0) redis = NULL;
+            }
+
+            for (shared_ptr<RedisConnect> & redis : list){
+                if (redis == NULL) continue;
+
+                int readed = 0;
+                Command & cmd = redis->context;
+
+                if (cmd.finish(redis.get(),cmd.read(redis.get(),tmpl->timeout,readed)) < 0) redis = NULL;
+            }
+        }
+
+        int cnt = 0;
+
+        for (shared_ptr<RedisConnect> & redis : list){
+            if (redis == NULL) continue;
+
+            vec.push_back(redis);
+            cnt++;
+        }
+
+        return cnt;
+    }
+    /**用于检查是否可以使用 Redis 连接库。它检查连接库的模板对象中的端口是否已配置。
+     * 如果端口大于0，表示可以使用连接库，返回true；否则返回false。**/
+    static bool CanUse(){
+        return GetTemplate()->port > 0;
+    }
+    /**返回一个RedisConnect对象的指针。是静态类型的RedisConnect 实例，用于保存配置信息和管理连接。**/
+    static RedisConnect * GetTemplate(){
+        static RedisConnect redis;
+        return &redis;
+    }
+
+    /**线程亲和模式下每个线程缓存的连接。连接仍然属于连接池，线程退出时 thread_local 对象析构，连接自动归还连接池。**/
+    class ThreadCache{
+    public:
+        int generation = 0;   /**获取连接时的配置版本（GetGeneration）**/
+        int64 expire = 0;     /**到这个时间（毫秒）后把连接归还连接池再重新获取**/
+        int64 utime = 0;      /**最后一次使用的时间（毫秒）**/
+        shared_ptr<RedisConnect> redis;
+
+        ~ThreadCache(){
+            release();
+        }
+        void release(){
+            if (redis){
+                redis = NULL;
+                GetAffinityCount()--;
+            }
+        }
+    };
+    /**当前独占连接的线程数**/
+    static atomic<int> & GetAffinityCount(){
+        static atomic<int> count(0);
+        return count;
+    }
+    /**配置版本，每次 Setup 加一，线程缓存的连接版本不同时说明是按旧配置建立的**/
+    static atomic<int> & GetGeneration(){
+        static atomic<int> generation(0);
+        return generation;
+    }
+    /**线程亲和模式获取连接：线程第一次调用时从连接池取出一个连接并缓存在 thread_local 中，之后直接返回缓存的连接，
+     * 不再访问连接池和互斥锁。以下情况归还缓存的连接并重新获取：
+     * 1）连接不可用，或者 Setup 修改了配置（配置版本不同）；
+     * 2）独占超过 POOL_CHECK_INTERVAL，归还后由连接池按回收策略决定是否重用；线程空闲超过这个间隔时，重用前先 PING 检测，
+     *    相当于连接池对空闲连接的后台检测。
+     * 独占连接的线程数最多 POOL_THREAD_AFFINITY 个（不超过 POOL_MAXLEN - 1，至少留一个连接给其他线程），其余线程仍然走连接池。**/
+    static shared_ptr<RedisConnect> GetThreadInstance(){
+        thread_local ThreadCache cache;
+
+        int generation = GetGeneration().load(memory_order_acquire);
+
+        if (cache.redis){
+            int64 now = ResPool<RedisConnect>::Now();
+
+            if (cache.generation == generation && now < cache.expire && !cache.redis->isBroken()){
+                cache.utime = now;
+                return cache.redis;
+            }
+
+            if (cache.redis->isBroken()) GetPool().disable(cache.redis);
+
+            cache.release();
+        }
+
+        atomic<int> & count = GetAffinityCount();
+
+        if (++count > min(POOL_THREAD_AFFINITY,POOL_MAXLEN - 1)){
+            count--;
+            return GetTemplate()->grasp();
+        }
+
+        int64 now = ResPool<RedisConnect>::Now();
+        shared_ptr<RedisConnect> redis = GetTemplate()->grasp();
+
+        if (redis && POOL_CHECK_INTERVAL > 0 && cache.utime > 0 && now - cache.utime >= POOL_CHECK_INTERVAL){
+            if (!redis->probe()){
+                GetPool().disable(redis);
+                redis = GetTemplate()->grasp();
+            }
+        }
+
+        if (redis){
+            cache.redis = redis;
+            cache.utime = now;
+            cache.generation = generation;
+            cache.expire = POOL_CHECK_INTERVAL > 0 ? now + POOL_CHECK_INTERVAL : numeric_limits<int64>::max();
+        } else{
+            count--;
+        }
+
+        return redis;
+    }
+
+    /**运行指标快照：各命令类型的调用次数、错误次数、收发字节数、延迟分位数，以及连接池的状态，
+     * 可以通过 GetMetrics().toPrometheus() 导出为 Prometheus 文本格式。**/
+    static RedisMetrics::Snapshot GetMetrics(){
+        RedisMetrics::Snapshot snapshot;
+
+        snapshot.pool = GetPool().getStat();
+
+        snapshot.breakers = RedisBreaker::GetStatAll();
+
+        snapshot.commands = RedisMetrics::GetCommandStat();
+
+        return snapshot;
+    }
+
+    static shared_ptr<RedisConnect> Instance(){
+        /**安装了 RedisTracer 时记录获取连接的耗时，作为下一条命令跟踪信息中的 poolwait**/
+        if (RedisTracer::Get()){
+            int64 start = RedisTrace::Now();
+            shared_ptr<RedisConnect> redis = POOL_THREAD_AFFINITY > 0 ? GetThreadInstance() : GetTemplate()->grasp();
+
+            if (redis) redis->poolwait = RedisTrace::Now() - start;
+
+            return redis;
+        }
+        /**开启线程亲和模式时，每个线程复用自己缓存的连接**/
+        if (POOL_THREAD_AFFINITY > 0) return GetThreadInstance();
+
+        /**单例模式
+         * 确保只有一个全局唯一的RedisConnect对象存在。这个RedisConnect提供连接所需要的配置
+         * 线程池里的连接共享这个配置，不必单独为每个连接设置连接属性。
+         *
+         * GetTemplete()Instance() 返回的是一个指向 RedisConnect 对象的 shared_ptr 智能指针，
+         * 这里GetTemplete()返回的是Setup中创建的那个单例RedisConnect ，这个RedisConnect指针调用grasp()**/
+        return GetTemplate()->grasp();
+    }
+    /**用于设置 Redis 连接库的配置信息。
+     * 并没有建立socket连接，建立连接是在Instance()实现的
+     * @return 先调用GetTemplete()获取一个RedisConnect对象，
+     * 它接受host主机名（或 IP 地址）、port端口号、密码、超时时间和内存大小作为参数，
+     * 并将这些配置信息存储在连接库的模板对象中。在 Linux 下，它还忽略了SIGPIPE信号，以避免因管道破裂而导致程序崩溃。
+     * option 是连接建立后设置的 socket 选项，默认关闭 Nagle 算法并启用 keepalive。**/
+    static void Setup(const string & host,int port,const string & passwd = "",int timeout = 3000,int memsz = 2 * 1024 * 1024,const SocketOption & option = SocketOption()){
+#ifdef LINUX
+        /**signal()处理信号函数，第一个参数是接受的信号，第二个参数是接收到对应信号要进行的操作，这里是忽略SIGPIPE信号
+         *以下情况会触发SIGPIPE信号
+         * 1）管道和FIFO（有名管道）操作：如果你在一个管道（包括匿名管道和有名管道）上写入数据，而没有进程在读取这些数据，这将导致 SIGPIPE 信号。
+
+           2）在已经关闭的文件描述符上写：如果你试图向一个已经关闭的文件描述符（包括文件、套接字、管道等）写数据，操作系统会检测到这一情况并向进程发送 SIGPIPE 信号。
+
+           3）使用内存映射的共享内存：在一些共享内存的情况下，如果你写入一个已经分离的共享内存区域，这也会触发 SIGPIPE 信号。
+         *
+         * 在这里本项目主要处理的是第二种情况，防止向已经关闭的socket连接输入数据时直接导致程序中断的情况，会忽略这个错误
+         * **/
+        signal(SIGPIPE,SIG_IGN);
+#else
+        WSADATA data; WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+        RedisConnect * redis  = GetTemplate();
+        redis->host = host;
+        redis->port = port;
+        redis->memsz = memsz;
+        redis->passwd = passwd;
+        redis->timeout = timeout;
+        redis->option = option;
+
+        /**丢弃按旧配置创建的连接，然后按 POOL_MINIDLE 预热连接池，并启动后台线程定期 PING 空闲连接，
+         * 失效或按回收策略到期的连接会被移除并在后台补足，业务线程调用 Instance() 时不需要承担建立连接和认证的开销。**/
+        ResPool<RedisConnect>::Policy policy;
+        policy.maxlife = POOL_MAX_LIFETIME;
+        policy.maxidle = POOL_MAX_IDLETIME;
+        policy.maxuses = POOL_MAX_USES;
+
+        /**按 CONNECT_FAILURE_THRESHOLD、CONNECT_BACKOFF_MIN、CONNECT_BACKOFF_MAX 设置所有地址（包括 RedisHedge 的副本节点）的熔断策略，
+         * 这个地址的新配置不沿用之前的熔断状态**/
+        RedisBreaker::Policy breakerpolicy;
+        breakerpolicy.threshold = CONNECT_FAILURE_THRESHOLD;
+        breakerpolicy.mindelay = CONNECT_BACKOFF_MIN;
+        breakerpolicy.maxdelay = CONNECT_BACKOFF_MAX;
+
+        RedisBreaker::SetPolicyAll(breakerpolicy);
+
+        redis->breaker = RedisBreaker::Get(host,port);
+        redis->breaker->reset();
+
+        /**线程亲和模式下缓存的旧连接在下次使用时发现版本变化后丢弃**/
+        GetGeneration()++;
+
+        ResPool<RedisConnect> & pool = GetPool();
+        pool.clear();
+        pool.setPolicy(policy);
+        pool.setMinIdle(POOL_MINIDLE);
+        pool.setBatchCreator([](int count,vector<shared_ptr<RedisConnect>> & vec){
+            return Create(count,vec);
+        });
+        pool.setChecker([](shared_ptr<RedisConnect> redis){
+            return redis->probe();
+        }, POOL_CHECK_INTERVAL);
+        pool.prepare();
+    }
+};
+
+
+
+int RedisConnect::POOL_MAXLEN = 8;
+int RedisConnect::POOL_MINIDLE = 0;
+int RedisConnect::POOL_CHECK_INTERVAL = 5000;
+int RedisConnect::POOL_MAX_LIFETIME = 0;
+int RedisConnect::POOL_MAX_IDLETIME = 60000;
+int RedisConnect::POOL_MAX_USES = 0;
+int RedisConnect::POOL_THREAD_AFFINITY = 0;
+bool RedisConnect::METRICS_ENABLED = true;
+int RedisConnect::COMPRESS_TYPE = RedisCompress::NONE;
+int RedisConnect::COMPRESS_LEVEL = 0;
+int RedisConnect::COMPRESS_THRESHOLD = 4096;
+int RedisConnect::SOCKET_TIMEOUT = 10;
+int RedisConnect::COMMAND_RETRY_TIMES = 1;
+int RedisConnect::BLOCK_RECV_TIMEOUT = 100;
+int RedisConnect::DNS_CACHE_TIME = 60000;
+int RedisConnect::CONNECT_ATTEMPT_DELAY = 250;
+int RedisConnect::CONNECT_FAILURE_THRESHOLD = 3;
+int RedisConnect::CONNECT_BACKOFF_MIN = 100;
+int RedisConnect::CONNECT_BACKOFF_MAX = 5000;
+#endif //REDISCONNECT_REDISCONNECT_MYSELF_H
+
+
+
+
+
@@ -1,230 +1,623 @@
-//
-// Created by LZH on 2023/9/28.
-//
-
-#ifndef   RESPOOL_H
-#define   RESPOOL_H
-//////////////////////////////////////////////////////////////////////////////
-#include "typedef.h"
-
-#include <ctime>
-#include <mutex>
-#include <vector>
-#include <string>
-#include <memory>
-#include <thread>
-#include <sstream>
-#include <iostream>
-#include <iterator>
-#include <typeinfo>
-#include <algorithm>
-#include <functional>
-
-using namespace std;
-
-template<typename T> class ResPool
-{
-    /**内部类，用于管理资源池中的每个资源。**/
-    class Data
-    {
-    public:
-        int num;             /**表示资源被使用的次数。**/
-        time_t utime;        /**表示资源最后一次被使用的时间。**/
-        shared_ptr<T> data;  /**使用 shared_ptr 来保存资源对象。**/
-
-        /**用于获取资源，并在每次获取资源时更新 utime 和 num。  **/
-        shared_ptr<T> get()
-        {
-            utime = time(NULL);
-            num++;
-
-            return data;
-        }
-        /**用于获取资源，并在每次获取资源时更新 utime 和 num。**/
-        Data(shared_ptr<T> data)
-        {
-            update(data);
-        }
-        /**用于更新 Data 对象的资源和重置 num 和 utime。**/
-        void update(shared_ptr<T> data)
-        {
-            this->num = 0;
-            this->data = data;
-            this->utime = time(NULL);
-        }
-    };
-
-protected:
-    mutex mtx;    /**个互斥锁，用于在多线程环境中对资源池进行互斥访问。**/
-    int maxlen;   /**资源池中的最大资源数量。**/
-    int timeout;  /**资源的超时时间，在多长时间内没有被使用后将被清理。**/
-    vector<Data> vec;  /**保存 Data 对象的向量，用于存储资源。**/
-    function<shared_ptr<T>()> func; /****/
-
-public:
-    /**从资源池中获取资源对象 shared_ptr<T>**/
-    shared_ptr<T> get()
-    {
-        /**timeout 若小于0表示不启用超时机制，直接通过 func() 调用创建资源对象并返回。**/
-        if (timeout <= 0) return func();
-
-        auto grasp = [&](){
-            int len = 0;  /**连接池资源数**/
-            int idx = -1; /**当前索引**/
-            shared_ptr<T> tmp;  /**暂存**/
-            time_t now = time(NULL);  /**获取当前时间**/
-
-            mtx.lock();  /**加锁，以确保后续的操作是线程安全的。**/
-
-            len = vec.size();
-            /**遍历资源池中的资源对象：**/
-            for (int i = 0; i < len; i++)
-            {
-                /**获取资源对象**/
-                Data& item = vec[i];
-                /**如果资源对象的指针为空（item.data.get() == NULL）或者只有当前 grasp 函数引用它（item.data.use_count() == 1）**/
-                if (item.data.get() == NULL || item.data.use_count() == 1)
-                {
-
-                    if (tmp = item.data)
-                    {
-                        /**资源对象的使用次数小于 100 且超时时间内表示资源对象可以重用。**/
-                        if (item.num < 100 && item.utime + timeout > now)
-                        {
-                            shared_ptr<T> data = item.get();
-
-                            /**释放互斥锁，解锁资源池。**/
-                            mtx.unlock();
-
-                            return data;
-                        }
-                        /**将资源对象的item.data 置为空，表示该资源对象不可重用。**/
-                        item.data = NULL;
-                    }
-                    /**记录当前可重用资源的索引。**/
-                    idx = i;
-                }
-            }
-
-            mtx.unlock();
-
-            if (idx < 0)
-            {
-                /**首先检查资源池中的资源数量是否已经达到最大长度（len >= maxlen），如果是，
-                 * 说明资源池已满，无法创建新的资源对象，因此直接返回一个空的 shared_ptr<T>()。**/
-                if (len >= maxlen) return shared_ptr<T>();
-                /**如果资源池未满，则通过调用 func() 函数创建一个新的资源对象，并将其赋值给 data。**/
-                shared_ptr<T> data = func();
-                /**如果新创建的资源对象为空，直接返回该对象。
-                 * 这行代码 `if (data.get() == NULL) return data;` 的目的是检查通过 `func()` 创建的新资源对象是否为 `NULL`。
-                 * 如果资源对象为 `NULL`，这意味着创建失败或出现了问题，因此没有必要将它插入到 `vec` 中，而是直接返回一个空的 `shared_ptr<T>`，
-                 * 以指示获取资源失败。在这种情况下，将资源对象添加到 `vec` 中不会改变它为 `NULL` 的事实，因此可以避免不必要的操作和资源池的变化。**/
-                if (data.get() == NULL) return data;
-
-                mtx.lock();
-                /**如果资源池的大小仍然小于最大长度（maxlen），则将新创建的资源对象 data 添加到资源池中。**/
-                if (vec.size() < maxlen) vec.push_back(data);
-
-                mtx.unlock();
-
-                return data;
-            }
-            /**如果idx不为-1，说明idx索引处的索引可重用，先调用func()，若获取到的data为NULL，直接返回
-             * 如果不为NULL，上锁更新后再解锁**/
-            shared_ptr<T> data = func();
-
-            if (data.get() == NULL) return data;
-
-            mtx.lock();
-
-            vec[idx].update(data);
-
-            mtx.unlock();
-
-            return data;
-        };
-        /**尝试调用 grasp() 函数获取资源，并将获取到的资源保存在 data 变量中**/
-        shared_ptr<T> data = grasp();
-        /**如果 data 为非空（即成功获取到资源），则直接返回 data，表示成功获取资源，可以在外部使用了。**/
-        if (data) return data;
-        /**如果第一次获取资源失败，设置一个截止时间 endtime，这个时间比当前时间晚 3 秒。然后进入一个无限循环，等待获取资源成功或者超过截止时间。**/
-        time_t endtime = time(NULL) + 3;
-
-        while (true)
-        {   /**休眠 10 毫秒**/
-            Sleep(10);
-            /**检查 data 是否为有效的 shared_ptr。如果获取到资源（data 非空），则直接返回 data，表示成功获取资源。**/
-            if (data = grasp()) return data;
-            /**如果获取资源失败并且当前时间超过了截止时间 endtime，则退出循环，表示未能在规定时间内获取到资源。**/
-            if (endtime < time(NULL)) break;
-        }
-        /**如果 data 为 NULL，则表示在规定时间内未能成功获取到资源。**/
-        return data;
-    }
-    /**清空资源池**/
-    void clear()
-    {
-        /**使用 lock_guard 对象 lk 锁住了 mtx，这是为了保证在清空资源池时不会被其他线程同时修改，确保线程安全。**/
-        lock_guard<mutex> lk(mtx);
-
-        vec.clear();
-    }
-    int getLength() const
-    {
-        return maxlen;
-    }
-    int getTimeout() const
-    {
-        return timeout;
-    }
-    void disable(shared_ptr<T> data)
-    {
-        lock_guard<mutex> lk(mtx);
-
-        for (Data& item : vec)
-        {
-            if (data == item.data)
-            {
-                item.data = NULL;
-
-                break;
-            }
-        }
-    }
-    void setLength(int maxlen)
-    {
-        lock_guard<mutex> lk(mtx);
-
-        this->maxlen = maxlen;
-
-        if (vec.size() > maxlen) vec.clear();
-    }
-    void setTimeout(int timeout)
-    {
-        lock_guard<mutex> lk(mtx);
-
-        this->timeout = timeout;
-
-        if (timeout <= 0) vec.clear();
-    }
-    void setCreator(function<shared_ptr<T>()> func)
-    {
-        lock_guard<mutex> lk(mtx);
-
-        this->func = func;
-        this->vec.clear();
-    }
-    ResPool(int maxlen = 8, int timeout = 60)
-    {
-        this->timeout = timeout;
-        this->maxlen = maxlen;
-    }
-    ResPool(function<shared_ptr<T>()> func, int maxlen = 8, int timeout = 60)
-    {
-        this->timeout = timeout;
-        this->maxlen = maxlen;
-        this->func = func;
-    }
-};
-//////////////////////////////////////////////////////////////////////////////
+//
+// Created by LZH on 2023/9/28.
+//
+
+#ifndef   RESPOOL_H
+#define   RESPOOL_H
+//////////////////////////////////////////////////////////////////////////////
+#include "typedef.h"
+
+#include <ctime>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <sstream>
+#include <iostream>
+#include <iterator>
+#include <typeinfo>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+using namespace std;
+
+/**资源池的状态快照**/
+struct ResPoolStat
+{
+    int maxlen = 0;        /**最大资源数量**/
+    int inuse = 0;         /**正在使用的资源数量**/
+    int idle = 0;          /**空闲资源数量**/
+    int64 waits = 0;       /**需要等待空闲资源的获取次数**/
+    int64 waittime = 0;    /**等待空闲资源的累计时间（毫秒）**/
+    int64 creations = 0;   /**创建资源的次数**/
+    int64 evictions = 0;   /**回收资源的次数（到期、检测失败或被 disable）**/
+};
+
+template<typename T> class ResPool
+{
+public:
+    /**资源回收策略，各项取值小于等于0表示不限制。
+     * 全部不限制时，资源只会因为健康检测失败或被 disable 而回收。**/
+    struct Policy
+    {
+        int maxlife = 0;  /**资源的最长存活时间（毫秒），从创建时开始计算。**/
+        int maxidle = 0;  /**资源的最长空闲时间（毫秒），超过后不再重用。**/
+        int maxuses = 0;  /**资源的最多使用次数。**/
+    };
+
+    /**单调时钟的当前时间（毫秒），不受系统时间调整的影响。**/
+    static int64 Now()
+    {
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+protected:
+    /**内部类，用于管理资源池中的每个资源。**/
+    class Data
+    {
+    public:
+        int num;             /**表示资源被使用的次数。**/
+        int64 ctime;         /**表示资源的创建时间（毫秒）。**/
+        int64 utime;         /**表示资源最后一次被使用的时间（毫秒）。**/
+        shared_ptr<T> data;  /**使用 shared_ptr 来保存资源对象。**/
+
+        /**用于获取资源，并在每次获取资源时更新 utime 和 num。  **/
+        shared_ptr<T> get(int64 now)
+        {
+            utime = now;
+            num++;
+
+            return data;
+        }
+        /**用于获取资源，并在每次获取资源时更新 utime 和 num。**/
+        Data(shared_ptr<T> data)
+        {
+            update(data);
+        }
+        /**用于更新 Data 对象的资源和重置 num 和 utime。**/
+        void update(shared_ptr<T> data)
+        {
+            this->num = 0;
+            this->data = data;
+            this->ctime = this->utime = Now();
+        }
+    };
+
+protected:
+    mutex mtx;    /**个互斥锁，用于在多线程环境中对资源池进行互斥访问。**/
+    int maxlen;   /**资源池中的最大资源数量。**/
+    int timeout;  /**资源的超时时间（秒），小于等于0表示不使用资源池。**/
+    Policy policy;     /**资源回收策略**/
+    int minidle = 0;   /**资源池中至少保持的空闲资源数量，由后台线程负责补足。**/
+    int interval = 0;  /**后台检测线程的检测间隔（毫秒），小于等于0表示不启用后台线程。**/
+    bool stopped = false; /**通知后台线程退出**/
+    bool refill = false;  /**通知后台线程立即补充资源**/
+    int pending = 0;      /**按存活时间、使用次数回收后等待后台线程补建的资源数量，不受 minidle 限制**/
+    thread worker;        /**后台检测线程**/
+    condition_variable cv; /**用于唤醒后台线程**/
+    vector<Data> vec;  /**保存 Data 对象的向量，用于存储资源。**/
+    function<shared_ptr<T>()> func; /****/
+    function<int(int, vector<shared_ptr<T>>&)> batch; /**批量创建资源的函数，返回创建成功的数量**/
+    function<bool(shared_ptr<T>)> checker; /**资源健康检测函数，返回false表示资源已失效**/
+    atomic<int64> waits;      /**需要等待空闲资源的获取次数**/
+    atomic<int64> waittime;   /**等待空闲资源的累计时间（毫秒）**/
+    atomic<int64> creations;  /**创建资源的次数**/
+    atomic<int64> evictions;  /**回收资源的次数**/
+
+    /**调用 func 创建资源并计数**/
+    shared_ptr<T> create(const function<shared_ptr<T>()>& func)
+    {
+        shared_ptr<T> data = func();
+
+        if (data) creations++;
+
+        return data;
+    }
+
+    /**创建 num 个资源放入资源池，返回放入的数量。
+     * 设置了批量创建函数时一次创建全部资源（例如同时建立多个连接），否则逐个调用 func 创建。**/
+    int fill(int num)
+    {
+        int cnt = 0;
+        function<shared_ptr<T>()> func;
+        function<int(int, vector<shared_ptr<T>>&)> batch;
+
+        if (num <= 0) return 0;
+
+        mtx.lock();
+
+        func = this->func;
+        batch = this->batch;
+
+        mtx.unlock();
+
+        if (batch)
+        {
+            vector<shared_ptr<T>> list;
+
+            creations += batch(num, list);
+
+            lock_guard<mutex> lk(mtx);
+
+            for (shared_ptr<T>& data : list)
+            {
+                if (!put(data)) break;
+
+                cnt++;
+            }
+
+            return cnt;
+        }
+
+        while (func && num-- > 0)
+        {
+            shared_ptr<T> data = create(func);
+
+            if (data.get() == NULL) break;
+
+            lock_guard<mutex> lk(mtx);
+
+            if (!put(data)) break;
+
+            cnt++;
+        }
+
+        return cnt;
+    }
+    /**在资源池中放入一个新创建的资源，优先复用空槽位，调用前需要加锁。
+     * 资源池已满时返回false。**/
+    bool put(shared_ptr<T> data)
+    {
+        for (Data& item : vec)
+        {
+            if (item.data.get() == NULL)
+            {
+                item.update(data);
+
+                return true;
+            }
+        }
+
+        if ((int)(vec.size()) >= maxlen) return false;
+
+        vec.push_back(data);
+
+        return true;
+    }
+    /**按回收策略判断资源是否需要回收，ahead 表示提前量（毫秒），后台线程用它提前替换即将到期的资源。
+     * 提前量最多取时间限制的四分之一，时间限制不长于检测间隔时，不会因为提前量把刚使用过的资源全部回收。**/
+    bool expired(const Data& item, int64 now, int64 ahead = 0) const
+    {
+        if (policy.maxuses > 0 && item.num >= policy.maxuses) return true;
+        if (policy.maxlife > 0 && item.ctime + policy.maxlife <= now + min<int64>(ahead, policy.maxlife / 4)) return true;
+
+        return idled(item, now, ahead);
+    }
+    /**资源是否因为空闲时间过长而到期。这样回收的资源说明当前用不到这么多，不需要补建。**/
+    bool idled(const Data& item, int64 now, int64 ahead = 0) const
+    {
+        return policy.maxidle > 0 && item.utime + policy.maxidle <= now + min<int64>(ahead, policy.maxidle / 4);
+    }
+    /**统计空闲资源数量与有效资源数量，调用前需要加锁。**/
+    void count(int& idle, int& live) const
+    {
+        idle = live = 0;
+
+        for (const Data& item : vec)
+        {
+            if (item.data.get() == NULL) continue;
+
+            live++;
+
+            if (item.data.use_count() == 1) idle++;
+        }
+    }
+    /**后台线程的一轮工作：
+     * 1）按回收策略移除到期（或在下一轮检测前就会到期）的空闲资源；
+     * 2）取出当前所有空闲资源，在锁外调用 checker 检测（检测期间引用计数大于1，get()不会把它分配出去），失效的资源直接移出资源池；
+     * 3）空闲资源不足 minidle 时在后台线程中创建新资源补足（有批量创建函数时一次补足），这样调用 get() 的业务线程就不需要承担建立连接的开销。
+     *    按存活时间、使用次数回收的资源（包括 get() 中回收的）即使 minidle 为0也会补建，因空闲时间过长回收的不补建。**/
+    void check()
+    {
+        int idle = 0;
+        int live = 0;
+        int64 now = Now();
+        vector<shared_ptr<T>> list;
+        vector<shared_ptr<T>> recycled;
+        function<shared_ptr<T>()> func;
+        function<bool(shared_ptr<T>)> checker;
+
+        mtx.lock();
+
+        func = this->func;
+        checker = this->checker;
+
+        for (Data& item : vec)
+        {
+            if (item.data.get() == NULL || item.data.use_count() > 1) continue;
+
+            if (expired(item, now, interval))
+            {
+                /**在锁外释放到期的资源**/
+                recycled.push_back(item.data);
+                item.data = NULL;
+                evictions++;
+
+                if (!idled(item, now, interval)) pending++;
+            }
+            else if (checker)
+            {
+                list.push_back(item.data);
+            }
+        }
+
+        mtx.unlock();
+
+        recycled.clear();
+
+        for (shared_ptr<T>& data : list)
+        {
+            if (checker(data)) continue;
+
+            disable(data);
+        }
+
+        list.clear();
+
+        mtx.lock();
+
+        count(idle, live);
+
+        int num = func ? min(max(minidle - idle, pending), maxlen - live) : 0;
+
+        pending = 0;
+
+        mtx.unlock();
+
+        fill(num);
+    }
+    /**启动后台线程，调用前需要加锁。**/
+    void start()
+    {
+        if (worker.joinable() || interval <= 0) return;
+
+        worker = thread([this](){
+            unique_lock<mutex> lk(mtx);
+
+            while (!stopped)
+            {
+                cv.wait_for(lk, chrono::milliseconds(interval), [this](){
+                    return stopped || refill;
+                });
+
+                if (stopped) break;
+
+                refill = false;
+
+                lk.unlock();
+
+                check();
+
+                lk.lock();
+            }
+        });
+    }
+    /**停止并等待后台线程退出**/
+    void stop()
+    {
+        mtx.lock();
+
+        stopped = true;
+
+        mtx.unlock();
+
+        cv.notify_all();
+
+        if (worker.joinable()) worker.join();
+    }
+    /**唤醒后台线程补充资源，调用前需要加锁。**/
+    void notify()
+    {
+        if ((minidle <= 0 && pending <= 0) || !worker.joinable()) return;
+
+        refill = true;
+
+        cv.notify_one();
+    }
+
+public:
+    /**从资源池中获取资源对象 shared_ptr<T>**/
+    shared_ptr<T> get()
+    {
+        /**timeout 若小于0表示不启用超时机制，直接通过 func() 调用创建资源对象并返回。**/
+        if (timeout <= 0) return create(func);
+
+        /**资源创建失败（例如服务端不可用）时不再等待，直接返回 NULL，只有资源池已满时才等待其他线程归还资源。**/
+        bool failed = false;
+
+        auto grasp = [&](){
+            int len = 0;  /**连接池资源数**/
+            int idx = -1; /**当前索引**/
+            int lost = 0; /**按存活时间、使用次数回收的资源数量**/
+            int64 now = Now();  /**获取当前时间**/
+            vector<shared_ptr<T>> recycled;  /**到期的资源，在锁外释放（返回时析构）**/
+
+            mtx.lock();  /**加锁，以确保后续的操作是线程安全的。**/
+
+            len = vec.size();
+            /**遍历资源池中的资源对象：**/
+            for (int i = 0; i < len; i++)
+            {
+                /**获取资源对象**/
+                Data& item = vec[i];
+                /**如果资源对象的指针为空（item.data.get() == NULL）或者只有当前 grasp 函数引用它（item.data.use_count() == 1）**/
+                if (item.data.get() == NULL || item.data.use_count() == 1)
+                {
+
+                    if (item.data)
+                    {
+                        /**按回收策略（使用次数、存活时间、空闲时间）判断资源对象是否可以重用。**/
+                        if (!expired(item, now))
+                        {
+                            shared_ptr<T> data = item.get(now);
+
+                            /**前面回收的资源交给后台线程补建**/
+                            if (lost > 0)
+                            {
+                                pending += lost;
+                                notify();
+                            }
+
+                            /**释放互斥锁，解锁资源池。**/
+                            mtx.unlock();
+
+                            return data;
+                        }
+                        /**将资源对象的item.data 置为空，表示该资源对象不可重用。**/
+                        if (!idled(item, now)) lost++;
+
+                        recycled.push_back(item.data);
+                        item.data = NULL;
+                        evictions++;
+                    }
+                    /**记录当前可重用资源的索引。**/
+                    idx = i;
+                }
+            }
+            /**没有可用的空闲资源，当前线程需要自己创建资源，同时唤醒后台线程补充空闲资源，
+             * 回收的资源中除了当前线程马上要重建的一个，其余的由后台线程补建。**/
+            if (lost > 1) pending += lost - 1;
+
+            notify();
+
+            mtx.unlock();
+
+            recycled.clear();
+
+            if (idx < 0)
+            {
+                /**首先检查资源池中的资源数量是否已经达到最大长度（len >= maxlen），如果是，
+                 * 说明资源池已满，无法创建新的资源对象，因此直接返回一个空的 shared_ptr<T>()。**/
+                if (len >= maxlen) return shared_ptr<T>();
+                /**如果资源池未满，则通过调用 func() 函数创建一个新的资源对象，并将其赋值给 data。**/
+                shared_ptr<T> data = create(func);
+
+                failed = data.get() == NULL;
+                /**如果新创建的资源对象为空，直接返回该对象。
+                 * 这行代码 `if (data.get() == NULL) return data;` 的目的是检查通过 `func()` 创建的新资源对象是否为 `NULL`。
+                 * 如果资源对象为 `NULL`，这意味着创建失败或出现了问题，因此没有必要将它插入到 `vec` 中，而是直接返回一个空的 `shared_ptr<T>`，
+                 * 以指示获取资源失败。在这种情况下，将资源对象添加到 `vec` 中不会改变它为 `NULL` 的事实，因此可以避免不必要的操作和资源池的变化。**/
+                if (data.get() == NULL) return data;
+
+                mtx.lock();
+                /**如果资源池的大小仍然小于最大长度（maxlen），则将新创建的资源对象 data 添加到资源池中。**/
+                if ((int)(vec.size()) < maxlen) vec.push_back(data);
+
+                mtx.unlock();
+
+                return data;
+            }
+            /**如果idx不为-1，说明idx索引处的索引可重用，先调用func()，若获取到的data为NULL，直接返回
+             * 如果不为NULL，上锁更新后再解锁**/
+            shared_ptr<T> data = create(func);
+
+            failed = data.get() == NULL;
+
+            if (failed) return data;
+
+            mtx.lock();
+
+            vec[idx].update(data);
+
+            mtx.unlock();
+
+            return data;
+        };
+        /**尝试调用 grasp() 函数获取资源，并将获取到的资源保存在 data 变量中**/
+        shared_ptr<T> data = grasp();
+        /**如果 data 为非空（即成功获取到资源），则直接返回 data，表示成功获取资源，可以在外部使用了。**/
+        if (data || failed) return data;
+        /**如果第一次获取资源失败，设置一个截止时间 endtime，这个时间比当前时间晚 3 秒。然后进入一个无限循环，等待获取资源成功或者超过截止时间。**/
+        int64 start = Now();
+        int64 endtime = start + 3000;
+
+        waits++;
+
+        while (true)
+        {   /**休眠 10 毫秒**/
+            Sleep(10);
+            /**检查 data 是否为有效的 shared_ptr。如果获取到资源（data 非空），则直接返回 data，表示成功获取资源。**/
+            if ((data = grasp()) || failed) break;
+            /**如果获取资源失败并且当前时间超过了截止时间 endtime，则退出循环，表示未能在规定时间内获取到资源。**/
+            if (endtime < Now()) break;
+        }
+
+        waittime += Now() - start;
+
+        /**如果 data 为 NULL，则表示在规定时间内未能成功获取到资源。**/
+        return data;
+    }
+    /**清空资源池**/
+    void clear()
+    {
+        /**使用 lock_guard 对象 lk 锁住了 mtx，这是为了保证在清空资源池时不会被其他线程同时修改，确保线程安全。**/
+        lock_guard<mutex> lk(mtx);
+
+        vec.clear();
+    }
+    int getLength() const
+    {
+        return maxlen;
+    }
+    int getTimeout() const
+    {
+        return timeout;
+    }
+    Policy getPolicy() const
+    {
+        return policy;
+    }
+    /**资源池的状态快照**/
+    ResPoolStat getStat()
+    {
+        ResPoolStat stat;
+
+        mtx.lock();
+
+        count(stat.idle, stat.inuse);
+
+        stat.maxlen = maxlen;
+        stat.inuse -= stat.idle;
+
+        mtx.unlock();
+
+        stat.waits = waits;
+        stat.waittime = waittime;
+        stat.creations = creations;
+        stat.evictions = evictions;
+
+        return stat;
+    }
+    void disable(shared_ptr<T> data)
+    {
+        lock_guard<mutex> lk(mtx);
+
+        for (Data& item : vec)
+        {
+            if (data == item.data)
+            {
+                item.data = NULL;
+                evictions++;
+
+                break;
+            }
+        }
+
+        notify();
+    }
+    void setLength(int maxlen)
+    {
+        lock_guard<mutex> lk(mtx);
+
+        this->maxlen = maxlen;
+
+        if (vec.size() > maxlen) vec.clear();
+    }
+    void setTimeout(int timeout)
+    {
+        lock_guard<mutex> lk(mtx);
+
+        this->timeout = timeout;
+        this->policy.maxidle = timeout * 1000;
+
+        if (timeout <= 0) vec.clear();
+    }
+    /**设置资源回收策略，新的策略对已经在资源池中的资源同样生效。**/
+    void setPolicy(const Policy& policy)
+    {
+        lock_guard<mutex> lk(mtx);
+
+        this->policy = policy;
+
+        notify();
+    }
+    void setCreator(function<shared_ptr<T>()> func)
+    {
+        lock_guard<mutex> lk(mtx);
+
+        this->func = func;
+        this->vec.clear();
+    }
+    /**设置批量创建资源的函数，预热和后台补充资源时一次创建所需的全部资源。**/
+    void setBatchCreator(function<int(int, vector<shared_ptr<T>>&)> batch)
+    {
+        lock_guard<mutex> lk(mtx);
+
+        this->batch = batch;
+    }
+    int getMinIdle() const
+    {
+        return minidle;
+    }
+    /**设置最少空闲资源数量，由后台线程补足（需要先调用 setChecker 启动后台线程）。**/
+    void setMinIdle(int minidle)
+    {
+        lock_guard<mutex> lk(mtx);
+
+        this->minidle = min(minidle, maxlen);
+
+        notify();
+    }
+    /**设置资源健康检测函数与检测间隔（毫秒），后台线程定期检测空闲资源并移除失效的资源。**/
+    void setChecker(function<bool(shared_ptr<T>)> checker, int interval = 5000)
+    {
+        lock_guard<mutex> lk(mtx);
+
+        this->checker = checker;
+        this->interval = interval;
+
+        start();
+    }
+    /**预热资源池，在当前线程中同步创建资源直到空闲资源数量达到 minidle，返回资源池中空闲资源的数量。**/
+    int prepare()
+    {
+        int idle = 0;
+        int live = 0;
+
+        mtx.lock();
+
+        count(idle, live);
+
+        int num = min(minidle - idle, maxlen - live);
+
+        mtx.unlock();
+
+        return idle + fill(num);
+    }
+    ResPool(int maxlen = 8, int timeout = 60)
+    {
+        this->timeout = timeout;
+        this->maxlen = maxlen;
+        this->policy.maxidle = timeout * 1000;
+        this->waits = this->waittime = this->creations = this->evictions = 0;
+    }
+    ResPool(function<shared_ptr<T>()> func, int maxlen = 8, int timeout = 60)
+    {
+        this->timeout = timeout;
+        this->maxlen = maxlen;
+        this->policy.maxidle = timeout * 1000;
+        this->waits = this->waittime = this->creations = this->evictions = 0;
+        this->func = func;
+    }
+    ~ResPool()
+    {
+        stop();
+    }
+};
+//////////////////////////////////////////////////////////////////////////////
 #endif
\ No newline at end of file